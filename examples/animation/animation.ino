@@ -96,11 +96,15 @@ void loop()
             continue;
         }
         if (counter < 80) {
+            if (counter == 10)
+                tm.refresh()->resetAnimation(); // Animations run side by side: stop blinking before scrolling
             tm.display("PLAY-STOP")->scrollLeft(500); // Scroll "PLAY-STOP" to the left each 500 milliseconds
             delay(500);
             continue;
         }
         if (counter < 90) {
+            if (counter == 80)
+                tm.refresh()->resetAnimation();
             tm.display(1.234354534)->fadeOut(800);  // Fade out 1.2345... every 800 milliseconds
             delay(1000);
             continue;
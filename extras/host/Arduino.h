@@ -0,0 +1,552 @@
+#ifndef TM1637_HOST_ARDUINO_H
+#define TM1637_HOST_ARDUINO_H
+
+/**
+ * @file Arduino.h
+ * @brief Minimal stand-in for the Arduino core so the driver can be built and profiled on a normal Linux box.
+ *
+ * @details Every pin operation is routed through `host::board()`, which keeps a simulated clock, counts the pin
+ * traffic and feeds the resulting line levels to the simulated TM1637 chips attached with `host::attachChip()`.
+ * Only the parts of the Arduino API used by the library and its examples are provided.
+ */
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+namespace host {
+
+    /**
+     * @brief Simulated cost of the Arduino primitives, in nanoseconds
+     * @details Defaults approximate a 16 MHz AVR running the stock core
+     */
+    struct Costs {
+        uint32_t pinModeNs = 3500;
+        uint32_t digitalWriteNs = 3500;
+        uint32_t digitalReadNs = 3000;
+        uint32_t portNs = 250;
+    };
+
+    /**
+     * @brief Counters accumulated by the simulated board. Reset them with `host::board().resetStats()`
+     */
+    struct Stats {
+        uint32_t pinOps;            // Calls to pinMode/digitalWrite/digitalRead and port register accesses
+        uint32_t toggles;           // Line level transitions seen on any pin
+        uint32_t transactions;      // Start conditions decoded by the attached chips
+        uint32_t bytes;             // Bytes decoded by the attached chips
+        uint32_t allocations;       // Heap (re)allocations done by String
+        uint64_t busNs;             // Simulated time spent in pin operations and busy-waits
+    };
+
+    /**
+     * @brief Simulated TM1637 chip decoding the two-wire protocol from the line levels
+     */
+    struct Chip {
+        uint8_t clkPin = 0xFF;
+        uint8_t dioPin = 0xFF;
+        uint8_t registers[6] = {};
+        uint8_t dataCommand = 0x40;
+        uint8_t displayControl = 0x80;
+        uint32_t transactions = 0;
+        uint32_t bytes = 0;
+        uint8_t keyCode = 0xFF;     // Answer to READ_KEY_SCAN_DATA, 0xFF when no key is pressed
+        uint8_t dropBytes = 0;      // Next bytes lost to line noise: neither stored nor acknowledged
+        uint32_t minPulseNs = 0;    // Shorter clock high phases are missed: the byte is lost like with dropBytes
+
+        bool pullsLow() const { return pullLow_; }
+
+        void edge(bool clk, bool dio, uint64_t nowNs = 0) {
+            if (clk && !clk_)
+                risingNs_ = nowNs;
+            else if (!clk && clk_ && active_ && !reading_ && bit_ < 8 && nowNs - risingNs_ < minPulseNs)
+                glitch_ = true;
+            if (clk && clk_ && dio != dio_) {
+                if (!dio) {
+                    active_ = true;
+                    bit_ = 0;
+                    shift_ = 0;
+                    index_ = 0;
+                    reading_ = false;
+                    glitch_ = false;
+                    ++transactions;
+                } else {
+                    active_ = false;
+                }
+            } else if (active_ && clk && !clk_) {
+                if (reading_) {
+                    if (bit_ < 8)
+                        ++bit_;
+                } else if (bit_ < 8) {
+                    shift_ |= static_cast<uint8_t>(dio ? 1u << bit_ : 0u);
+                    if (++bit_ == 8) {
+                        dropped_ = dropBytes != 0 || glitch_;
+                        if (dropBytes)
+                            --dropBytes;
+                        else
+                            receive(shift_);
+                    }
+                }
+            } else if (active_ && !clk && clk_) {
+                if (reading_) {
+                    // Key data goes out LSB first, each bit set up while the clock is low
+                    pullLow_ = bit_ < 8 && !((keyCode >> bit_) & 1u);
+                } else if (bit_ == 8 && !acking_) {
+                    acking_ = true;
+                    pullLow_ = !dropped_;
+                } else if (acking_) {
+                    acking_ = false;
+                    pullLow_ = false;
+                    glitch_ = false;
+                    bit_ = 0;
+                    shift_ = 0;
+                    if (readRequested_) {
+                        reading_ = true;
+                        pullLow_ = !(keyCode & 1u);
+                    }
+                }
+            }
+            clk_ = clk;
+            dio_ = dio;
+        }
+
+    private:
+        void receive(uint8_t value) {
+            ++bytes;
+            if (index_++ == 0) {
+                readRequested_ = (value & 0xC3u) == 0x42u;
+                switch (value & 0xC0u) {
+                    case 0x40u:
+                        dataCommand = value;
+                        break;
+                    case 0xC0u:
+                        address_ = static_cast<uint8_t>(value & 0x07u);
+                        break;
+                    case 0x80u:
+                        displayControl = value;
+                        break;
+                    default:
+                        break;
+                }
+                return;
+            }
+            if (address_ < sizeof(registers))
+                registers[address_] = value;
+            if (!(dataCommand & 0x04u))
+                ++address_;
+        }
+
+        bool clk_ = true, dio_ = true;
+        bool active_ = false, acking_ = false, pullLow_ = false, reading_ = false, readRequested_ = false;
+        bool dropped_ = false, glitch_ = false;
+        uint64_t risingNs_ = 0;
+        uint8_t bit_ = 0, shift_ = 0, index_ = 0, address_ = 0;
+    };
+
+    /**
+     * @brief Simulated board: pin states, clock and the chips wired to it
+     */
+    struct Board {
+        static constexpr uint8_t TOTAL_PINS = 64;
+        static constexpr uint8_t MAX_CHIPS = 8;
+
+        Costs costs;
+        Stats stats{};
+        uint64_t nowNs = 0;
+
+        void resetStats() { stats = Stats{}; }
+
+        Chip &attachChip(uint8_t clkPin, uint8_t dioPin) {
+            Chip &chip = chips_[totalChips_ < MAX_CHIPS ? totalChips_++ : MAX_CHIPS - 1];
+            chip = Chip{};
+            chip.clkPin = clkPin;
+            chip.dioPin = dioPin;
+            return chip;
+        }
+
+        void spend(uint64_t ns) {
+            nowNs += ns;
+            stats.busNs += ns;
+        }
+
+        bool level(uint8_t pin) const {
+            for (uint8_t counter = 0; counter < totalChips_; ++counter) {
+                if (chips_[counter].dioPin == pin && chips_[counter].pullsLow())
+                    return false;
+            }
+            return mode_[pin] == OUTPUT ? latch_[pin] : true;
+        }
+
+        bool latch(uint8_t pin) const { return pin < TOTAL_PINS && latch_[pin]; }
+
+        bool output(uint8_t pin) const { return pin < TOTAL_PINS && mode_[pin] == OUTPUT; }
+
+        void mode(uint8_t pin, uint8_t mode) {
+            if (pin >= TOTAL_PINS) return;
+            // Like the AVR core: INPUT clears the output latch, INPUT_PULLUP sets it
+            if (mode != OUTPUT)
+                latch_[pin] = mode == INPUT_PULLUP;
+            mode_[pin] = mode == OUTPUT ? OUTPUT : INPUT;
+            update();
+        }
+
+        void direction(uint8_t pin, bool output) {
+            if (pin >= TOTAL_PINS) return;
+            mode_[pin] = output ? OUTPUT : INPUT;
+            update();
+        }
+
+        void write(uint8_t pin, bool value) {
+            if (pin >= TOTAL_PINS) return;
+            latch_[pin] = value;
+            update();
+        }
+
+    private:
+        void update() {
+            // The chips react to each other's pull-downs, so settle until no line changes anymore
+            for (uint8_t round = 0; round < 4; ++round) {
+                bool changed = false;
+                for (uint8_t pin = 0; pin < TOTAL_PINS; ++pin) {
+                    bool current = level(pin);
+                    if (current != seen_[pin]) {
+                        seen_[pin] = current;
+                        ++stats.toggles;
+                        changed = true;
+                    }
+                }
+                if (!changed) return;
+                for (uint8_t counter = 0; counter < totalChips_; ++counter) {
+                    Chip &chip = chips_[counter];
+                    uint32_t before = chip.transactions, bytes = chip.bytes;
+                    chip.edge(seen_[chip.clkPin], seen_[chip.dioPin], nowNs);
+                    stats.transactions += chip.transactions - before;
+                    stats.bytes += chip.bytes - bytes;
+                }
+            }
+        }
+
+        Chip chips_[MAX_CHIPS];
+        uint8_t totalChips_ = 0;
+        uint8_t mode_[TOTAL_PINS] = {};
+        bool latch_[TOTAL_PINS] = {};
+        bool seen_[TOTAL_PINS] = {
+                true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true,
+                true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true,
+                true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true,
+                true, true, true, true, true, true, true, true, true, true, true, true, true, true, true, true,
+        };
+    };
+
+    inline Board &board() {
+        static Board instance;
+        return instance;
+    }
+
+    inline Chip &attachChip(uint8_t clkPin, uint8_t dioPin) { return board().attachChip(clkPin, dioPin); }
+
+    /**
+     * @brief AVR-like port register of the simulated board. Port `n` maps the pins `8 * n` to `8 * n + 7`
+     */
+    class PortRegister {
+    public:
+        enum Kind : uint8_t {
+            OUTPUT_REGISTER,
+            MODE_REGISTER,
+            INPUT_REGISTER
+        };
+
+        PortRegister &operator|=(unsigned mask) {
+            apply(mask & 0xFFu, true);
+            return *this;
+        }
+
+        PortRegister &operator&=(unsigned mask) {
+            apply(~mask & 0xFFu, false);
+            return *this;
+        }
+
+        PortRegister &operator=(unsigned value) {
+            ++board().stats.pinOps;
+            board().spend(board().costs.portNs);
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                uint8_t pin = static_cast<uint8_t>(port * 8 + bit);
+                if (kind == MODE_REGISTER)
+                    board().direction(pin, value & (1u << bit));
+                else if (kind == OUTPUT_REGISTER)
+                    board().write(pin, value & (1u << bit));
+            }
+            return *this;
+        }
+
+        operator uint8_t() const {
+            ++board().stats.pinOps;
+            board().spend(board().costs.portNs);
+            uint8_t value = 0;
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                uint8_t pin = static_cast<uint8_t>(port * 8 + bit);
+                bool set = kind == INPUT_REGISTER ? board().level(pin) :
+                           kind == MODE_REGISTER ? board().output(pin) : board().latch(pin);
+                value |= static_cast<uint8_t>(set << bit);
+            }
+            return value;
+        }
+
+        uint8_t port;
+        Kind kind;
+
+    private:
+        void apply(unsigned mask, bool value) {
+            ++board().stats.pinOps;
+            board().spend(board().costs.portNs);
+            for (uint8_t bit = 0; bit < 8; ++bit) {
+                if (!(mask & (1u << bit))) continue;
+                uint8_t pin = static_cast<uint8_t>(port * 8 + bit);
+                if (kind == MODE_REGISTER)
+                    board().direction(pin, value);
+                else if (kind == OUTPUT_REGISTER)
+                    board().write(pin, value);
+            }
+        }
+    };
+
+    inline PortRegister *portRegister(uint8_t port, PortRegister::Kind kind) {
+        static PortRegister registers[3][Board::TOTAL_PINS / 8];
+        PortRegister &reg = registers[kind][port % (Board::TOTAL_PINS / 8)];
+        reg.port = static_cast<uint8_t>(port % (Board::TOTAL_PINS / 8));
+        reg.kind = kind;
+        return &reg;
+    }
+}
+
+// Statement-expressions like the AVR core's, which reads these from PROGMEM tables: code that only compiles with
+// plain expressions (e.g. decltype at class scope) fails here too
+#define digitalPinToPort(P) (__extension__({ static_cast<uint8_t>((P) / 8); }))
+#define digitalPinToBitMask(P) (__extension__({ static_cast<uint8_t>(1u << ((P) % 8)); }))
+#define portOutputRegister(P) (__extension__({ host::portRegister((P), host::PortRegister::OUTPUT_REGISTER); }))
+#define portModeRegister(P) (__extension__({ host::portRegister((P), host::PortRegister::MODE_REGISTER); }))
+#define portInputRegister(P) (__extension__({ host::portRegister((P), host::PortRegister::INPUT_REGISTER); }))
+
+// The simulated port registers are objects, not memory-mapped bytes
+#define TM1637_PORT_REGISTER host::PortRegister
+
+inline void pinMode(uint8_t pin, uint8_t mode) {
+    ++host::board().stats.pinOps;
+    host::board().spend(host::board().costs.pinModeNs);
+    host::board().mode(pin, mode);
+}
+
+inline void digitalWrite(uint8_t pin, uint8_t value) {
+    ++host::board().stats.pinOps;
+    host::board().spend(host::board().costs.digitalWriteNs);
+    host::board().write(pin, value != LOW);
+}
+
+inline int digitalRead(uint8_t pin) {
+    ++host::board().stats.pinOps;
+    host::board().spend(host::board().costs.digitalReadNs);
+    return pin < host::Board::TOTAL_PINS && host::board().level(pin) ? HIGH : LOW;
+}
+
+inline void delayMicroseconds(unsigned int us) { host::board().spend(static_cast<uint64_t>(us) * 1000u); }
+
+inline void delay(unsigned long ms) { host::board().nowNs += static_cast<uint64_t>(ms) * 1000000u; }
+
+inline unsigned long micros() { return static_cast<unsigned long>(host::board().nowNs / 1000u); }
+
+inline unsigned long millis() { return static_cast<unsigned long>(host::board().nowNs / 1000000u); }
+
+inline long random(long low, long high) { return high > low ? low + rand() % (high - low) : low; }
+
+template<typename T, typename U>
+inline auto min(const T &a, const U &b) -> decltype(a < b ? a : b) { return a < b ? a : b; }
+
+template<typename T, typename U>
+inline auto max(const T &a, const U &b) -> decltype(a > b ? a : b) { return a > b ? a : b; }
+
+// Program memory is ordinary memory on the host
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(address) (__extension__({ *reinterpret_cast<const uint8_t *>(address); }))
+#define pgm_read_word(address) (__extension__({ *reinterpret_cast<const uint16_t *>(address); }))
+
+class __FlashStringHelper;
+
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(PSTR(string_literal)))
+
+/**
+ * @brief Byte source with the subset of the Arduino `Stream` API the library uses
+ */
+class Stream {
+public:
+    virtual ~Stream() = default;
+
+    virtual int available() = 0;
+
+    virtual int read() = 0;
+
+    virtual int peek() = 0;
+};
+
+/**
+ * @brief Heap-backed string with the subset of the Arduino `String` API the library uses
+ * @details Every (re)allocation is counted in `host::board().stats.allocations`
+ */
+class String {
+public:
+    String(const char *cstr = "") { assign(cstr, static_cast<unsigned>(strlen(cstr))); }
+
+    String(const String &rhs) { assign(rhs.buffer_, rhs.length_); }
+
+    explicit String(char c) { assign(&c, 1); }
+
+    explicit String(unsigned char value, unsigned char base = 10) { format(value, base); }
+
+    explicit String(int value, unsigned char base = 10) { format(value, base); }
+
+    explicit String(unsigned int value, unsigned char base = 10) { format(value, base); }
+
+    explicit String(long value, unsigned char base = 10) { format(value, base); }
+
+    explicit String(unsigned long value, unsigned char base = 10) { format(value, base); }
+
+    explicit String(float value, unsigned char decimalPlaces = 2) { format(static_cast<double>(value), decimalPlaces); }
+
+    explicit String(double value, unsigned char decimalPlaces = 2) { format(value, decimalPlaces); }
+
+    ~String() { free(buffer_); }
+
+    String &operator=(const String &rhs) {
+        if (this != &rhs) {
+            length_ = 0;
+            concat(rhs.buffer_, rhs.length_);
+        }
+        return *this;
+    }
+
+    String &operator=(const char *cstr) {
+        length_ = 0;
+        concat(cstr, static_cast<unsigned>(strlen(cstr)));
+        return *this;
+    }
+
+    unsigned int length() const { return length_; }
+
+    const char *c_str() const { return buffer_ ? buffer_ : ""; }
+
+    bool concat(char c) { return concat(&c, 1); }
+
+    bool concat(const String &rhs) { return concat(rhs.buffer_, rhs.length_); }
+
+    bool concat(const char *cstr, unsigned int length) {
+        if (!reserve(length_ + length))
+            return false;
+        if (length)
+            memcpy(buffer_ + length_, cstr, length);
+        length_ += length;
+        buffer_[length_] = '\0';
+        return true;
+    }
+
+    String substring(unsigned int left, unsigned int right) const {
+        if (left > right) {
+            unsigned int temp = right;
+            right = left;
+            left = temp;
+        }
+        String out;
+        if (left >= length_)
+            return out;
+        if (right > length_)
+            right = length_;
+        out.concat(buffer_ + left, right - left);
+        return out;
+    }
+
+    void remove(unsigned int index) {
+        if (index < length_) {
+            length_ = index;
+            buffer_[length_] = '\0';
+        }
+    }
+
+    char operator[](unsigned int index) const { return index < length_ ? buffer_[index] : '\0'; }
+
+    char &operator[](unsigned int index) {
+        static char dummy;
+        dummy = '\0';
+        return index < length_ ? buffer_[index] : dummy;
+    }
+
+    bool operator==(const String &rhs) const {
+        return length_ == rhs.length_ && (length_ == 0 || memcmp(buffer_, rhs.buffer_, length_) == 0);
+    }
+
+    bool operator!=(const String &rhs) const { return !(*this == rhs); }
+
+private:
+    bool reserve(unsigned int size) {
+        if (buffer_ && capacity_ >= size)
+            return true;
+        char *grown = static_cast<char *>(realloc(buffer_, size + 1));
+        if (!grown)
+            return false;
+        ++host::board().stats.allocations;
+        buffer_ = grown;
+        capacity_ = size;
+        return true;
+    }
+
+    void assign(const char *cstr, unsigned int length) {
+        length_ = 0;
+        concat(cstr, length);
+    }
+
+    void format(unsigned long value, unsigned char base, bool negative = false) {
+        char temp[36];
+        char *cursor = temp + sizeof(temp);
+        *--cursor = '\0';
+        do {
+            unsigned digit = static_cast<unsigned>(value % base);
+            *--cursor = static_cast<char>(digit < 10 ? '0' + digit : 'a' + digit - 10);
+            value /= base;
+        } while (value);
+        if (negative)
+            *--cursor = '-';
+        assign(cursor, static_cast<unsigned>(strlen(cursor)));
+    }
+
+    void format(long value, unsigned char base) {
+        if (value < 0 && base == 10)
+            format(static_cast<unsigned long>(-value), base, true);
+        else
+            format(static_cast<unsigned long>(value), base);
+    }
+
+    void format(int value, unsigned char base) { format(static_cast<long>(value), base); }
+
+    void format(unsigned int value, unsigned char base) { format(static_cast<unsigned long>(value), base); }
+
+    void format(unsigned char value, unsigned char base) { format(static_cast<unsigned long>(value), base); }
+
+    void format(double value, unsigned char decimalPlaces) {
+        char temp[330];
+        snprintf(temp, sizeof(temp), "%.*f", static_cast<int>(decimalPlaces), value);
+        assign(temp, static_cast<unsigned>(strlen(temp)));
+    }
+
+    char *buffer_ = nullptr;
+    unsigned int capacity_ = 0;
+    unsigned int length_ = 0;
+};
+
+#endif //TM1637_HOST_ARDUINO_H
@@ -0,0 +1,249 @@
+/**
+ * @file bench.cpp
+ * @brief Host benchmark measuring the bus cost of each public API call
+ *
+ * Build and run with `make -C extras/host run`. The figures are simulated: pin operations and busy-waits are
+ * charged with the costs in `host::Costs`, everything else is free. With TM1637_ASYNC the figures are the cost paid by
+ * the caller; the queued transfers are flushed afterwards, outside of the measurement.
+ */
+
+#include <Arduino.h>
+#include <TM1637.h>
+#include <TM1637Group.h>
+
+namespace {
+    const uint8_t CLK_PIN = 2;
+    const uint8_t DIO_PIN = 3;
+    const uint8_t STATIC_CLK_PIN = 4;
+    const uint8_t STATIC_DIO_PIN = 5;
+
+    TM1637 tm(CLK_PIN, DIO_PIN);
+    StaticTM1637<STATIC_CLK_PIN, STATIC_DIO_PIN> stm;
+    host::Chip &chip = host::attachChip(CLK_PIN, DIO_PIN);
+    host::Chip &staticChip = host::attachChip(STATIC_CLK_PIN, STATIC_DIO_PIN);
+
+    // Shared clock, data lines on the same port
+    const uint8_t GROUP_CLK_PIN = 16;
+    const uint8_t GROUP_DIO_PINS[] = {8, 9, 10, 11};
+    TM1637Group<4> group(GROUP_CLK_PIN, GROUP_DIO_PINS);
+    host::Chip &groupChip = host::attachChip(GROUP_CLK_PIN, GROUP_DIO_PINS[0]);
+    host::Chip &lastGroupChip = (host::attachChip(GROUP_CLK_PIN, GROUP_DIO_PINS[1]),
+            host::attachChip(GROUP_CLK_PIN, GROUP_DIO_PINS[2]), host::attachChip(GROUP_CLK_PIN, GROUP_DIO_PINS[3]));
+
+    void header() {
+        printf("%-32s %8s %8s %6s %6s %10s %7s  %s\n",
+               "call", "pin ops", "toggles", "xfers", "bytes", "bus us", "allocs", "registers");
+    }
+
+    template<typename F>
+    void measure(const char *name, const host::Chip &chip, F call, unsigned repeat = 1) {
+        host::board().resetStats();
+        for (unsigned counter = 0; counter < repeat; ++counter)
+            call();
+        const host::Stats stats = host::board().stats;
+#if TM1637_ASYNC
+        tm.flush();
+        stm.flush();
+#endif
+        printf("%-32s %8.1f %8.1f %6.1f %6.1f %10.2f %7.1f  %02X %02X %02X %02X / %02X\n", name,
+               static_cast<double>(stats.pinOps) / repeat,
+               static_cast<double>(stats.toggles) / repeat,
+               static_cast<double>(stats.transactions) / repeat,
+               static_cast<double>(stats.bytes) / repeat,
+               static_cast<double>(stats.busNs) / 1000.0 / repeat,
+               static_cast<double>(stats.allocations) / repeat,
+               chip.registers[0], chip.registers[1], chip.registers[2], chip.registers[3], chip.displayControl);
+    }
+
+    template<typename F>
+    void measure(const char *name, F call, unsigned repeat = 1) { measure(name, chip, call, repeat); }
+}
+
+int main() {
+    printf("sizeof(TM1637) %u bytes, sizeof(StaticTM1637) %u bytes\n", static_cast<unsigned>(sizeof(tm)),
+           static_cast<unsigned>(sizeof(stm)));
+    header();
+    measure("begin()", [] { tm.begin(); });
+    measure("display(1234)", [] { tm.display(1234); });
+    measure("display(1234) again", [] { tm.display(1234); });
+    int counter = 0;
+    measure("display(counter++)", [&counter] { tm.display(counter++); }, 100);
+    tm.setMaxFrameRate(50);
+    measure("50 fps: display + update / 1 ms", [&counter] {
+        tm.display(counter++);
+        tm.update();
+        delay(1);
+    }, 100);
+    tm.setMaxFrameRate(0);
+    tm.update();
+    static const float readings[] = {23.4f, 23.5f, 23.45f, 23.5f, 23.4f, 23.9f, 23.8f, 24.0f};
+    measure("noisy display(float)", [&counter] { tm.display(readings[counter++ % 8]); }, 16);
+    tm.setDeadband(0.3f);
+    measure("noisy display(float), deadband", [&counter] { tm.display(readings[counter++ % 8]); }, 16);
+    tm.setDeadband(0, 100);
+    measure("display(counter++), 100 ms hold", [&counter] {
+        tm.display(counter++);
+        delay(10);
+    }, 100);
+    tm.setDeadband(0);
+    measure("display(29.65)", [] { tm.display(29.65); });
+    measure("display(\"PLAY\")", [] { tm.display("PLAY"); });
+    static constexpr auto PLAY = tm1637_lib::encode("PLAY");
+    measure("display(String(\"STOP\"))", [] { tm.display(String("STOP")); });
+    measure("display(encode(\"PLAY\"))", [] { tm.display(PLAY); });
+    measure("display(F(\"STOP\"))", [] { tm.display(F("STOP")); });
+    static const uint8_t raw[] = {0x3F, 0x06, 0x5B, 0x4F};
+    measure("displayRawBytes(raw, 4)", [] { tm.displayRawBytes(raw, sizeof(raw)); });
+    measure("colonOn()", [] { tm.colonOn(); });
+    measure("colonOff()", [] { tm.colonOff(); });
+    measure("setDp(0x02)", [] { tm.setDp(0x02); });
+    measure("setDp(0x02) + colonOff() again", [] {
+        tm.setDp(0x02);
+        tm.colonOff();
+    });
+    measure("changeBrightness(5)", [] { tm.changeBrightness(5); });
+    measure("changeBrightnessPercent(50)", [] { tm.changeBrightnessPercent(50); });
+    measure("onMode()", [] { tm.onMode(); });
+    measure("display + colon + dp + brightness", [] {
+        tm.display(4567);
+        tm.colonOn();
+        tm.setDp(0x01);
+        tm.changeBrightness(3);
+    });
+    measure("same changes in a Batch", [] {
+        TM1637::Batch batch(tm);
+        tm.display(7654);
+        tm.colonOff();
+        tm.setDp(0x02);
+        tm.changeBrightness(6);
+    });
+    measure("offMode()", [] { tm.offMode(); });
+    measure("clearScreen()", [] { tm.clearScreen(); });
+    measure("refresh()", [] { tm.refresh(); });
+    Animator *animator = tm.display(9876);
+    animator->blink(10);
+    measure("blink() tick", [animator] {
+        delay(11);
+        animator->blink(10);
+    }, 10);
+    animator->resetAnimation();
+    tm.display(1234)->fadeOut(10);
+    measure("fadeOut() tick", [animator] {
+        delay(11);
+        animator->fadeOut(10);
+    }, 8);
+    animator->resetAnimation();
+    tm.display("PLAY-STOP")->marquee(10);
+    measure("marquee() tick", [animator] {
+        delay(11);
+        animator->marquee(10);
+    }, 26);
+    animator->resetAnimation();
+    tm.display("PLAY-STOP")->bounce(10);
+    measure("bounce() tick", [animator] {
+        delay(11);
+        animator->bounce(10);
+    }, 10);
+    animator->resetAnimation();
+    tm.display("PLAY-STOP")->scrollLeft(10);
+    measure("scrollLeft() tick", [animator] {
+        delay(11);
+        animator->scrollLeft(10);
+    }, 9);
+    animator->resetAnimation();
+    animator->stream(F("STREAMED FROM FLASH"), 10);
+    measure("stream(F(...)) tick", [animator] {
+        delay(11);
+        animator->stream(F("STREAMED FROM FLASH"), 10);
+    }, 23);
+    animator->resetAnimation();
+    tm.display("PLAY-STOP")->scrollLeft(10);
+    animator->fadeIn(25);
+    measure("scrollLeft() + fadeIn() tick", [animator] {
+        delay(11);
+        animator->tick();
+    }, 9);
+    printf("next animation step in %lu ms\n", static_cast<unsigned long>(animator->nextDeadline()));
+    measure("update() idle", [] { tm.update(); }, 10);
+    measure("update() every 11 ms", [] {
+        delay(11);
+        tm.update();
+    }, 9);
+    measure("update(300) every 11 ms", [] {
+        delay(11);
+        tm.update(300);
+    }, 9);
+    animator->resetAnimation();
+
+    header();
+    measure("StaticTM1637 begin()", staticChip, [] { stm.begin(); });
+    measure("StaticTM1637 display(1234)", staticChip, [] { stm.display(1234); });
+    measure("StaticTM1637 refresh()", staticChip, [] { stm.refresh(); });
+    measure("StaticTM1637 changeBrightness(5)", staticChip, [] { stm.changeBrightness(5); });
+
+    header();
+    chip.keyCode = 0xF6;
+    uint8_t keyCode = 0;
+    measure("readKeyCode()", [&keyCode] { keyCode = tm.readKeyCode(); });
+    measure("scanKeys() until debounced", [] {
+        while (!tm.scanKeys())
+            delay(TM1637_KEY_SCAN_INTERVAL);
+    });
+    printf("key code %02X, index %u, debounced key %u\n", keyCode, tm.keyIndex(keyCode), tm.getKey());
+    chip.keyCode = 0xFF;
+    measure("display(5678) after key scan", [] { tm.display(5678); });
+#if !TM1637_ASYNC
+    chip.dropBytes = 1;
+    measure("display(8765), one byte NAKed", [] { tm.display(8765); });
+    chip.dropBytes = 0xFF;
+    measure("display(8766), device not there", [] { tm.display(8766); });
+    chip.dropBytes = 0;
+    measure("display(8767) after failure", [] { tm.display(8767); });
+    printf("failed frames %u\n", tm.getFailures());
+    chip.minPulseNs = 1500;
+    tm.setBitDelay(10);
+    measure("calibrate() from 10 us", [] { tm.calibrate(); });
+    printf("calibrated bit delay %u us\n", tm.getBitDelay());
+    measure("display(4321) calibrated", [] { tm.display(4321); });
+    chip.minPulseNs = 0;
+    tm.setBitDelay(TM1637_DELAY);
+#endif
+
+    header();
+    measure("TM1637Group<4> begin()", groupChip, [] { group.begin(); });
+    measure("TM1637Group<4> display x4", groupChip, [] {
+        for (uint8_t index = 0; index < group.size(); ++index)
+            group[index].display(1234 + index);
+        group.refresh();
+    });
+    measure("TM1637Group<4> refresh()", lastGroupChip, [] { group.refresh(); });
+    measure("TM1637Group<4> one digit", lastGroupChip, [] {
+        group[3].display(1238);
+        group.refresh();
+    });
+    measure("TM1637Group<4> changeBrightness", lastGroupChip, [] {
+        group[3].changeBrightness(5);
+        group.refresh();
+    });
+#if TM1637_ASYNC
+
+    header();
+    measure("display(4321) + poll() to idle", [] {
+        tm.display(4321);
+        while (tm.poll());
+    });
+    tm.display(1111);
+    measure("poll() step", [] { tm.poll(); }, 20);
+#endif
+#if TM1637_STATS
+
+    const auto &stats = tm.getStatistics();
+    printf("tm: %lu transactions, %lu bytes, %lu NAKs, %lu retries, %lu frames sent, %lu skipped, %lu us on the bus, "
+           "%lu us max\n", static_cast<unsigned long>(stats.transactions), static_cast<unsigned long>(stats.bytes),
+           static_cast<unsigned long>(stats.naks), static_cast<unsigned long>(stats.retries),
+           static_cast<unsigned long>(stats.frames),
+           static_cast<unsigned long>(stats.skippedFrames), static_cast<unsigned long>(stats.busMicros),
+           static_cast<unsigned long>(stats.maxFrameMicros));
+#endif
+    return 0;
+}
@@ -4,11 +4,33 @@
 #include <Arduino.h>
 #include "type_traits.h"
 #include "animator.h"
+#include "formatter.h"
+#include "segments.h"
 
 #ifndef TM1637_LEGACY
 #define TM1637_LEGACY 1
 #endif
 
+// Default interval between two key scans in milliseconds, see BasicTM1637::scanKeys()
+#ifndef TM1637_KEY_SCAN_INTERVAL
+#define TM1637_KEY_SCAN_INTERVAL 10
+#endif
+
+// Default number of identical consecutive scans before a key change is accepted
+#ifndef TM1637_KEY_DEBOUNCE
+#define TM1637_KEY_DEBOUNCE 3
+#endif
+
+// Consecutive update() calls a frame can be held back by the time budget before it is sent regardless
+#ifndef TM1637_MAX_HOLDS
+#define TM1637_MAX_HOLDS 4
+#endif
+
+// Calibrate the bit delay of each display in begin(), see BasicTM1637::calibrate()
+#ifndef TM1637_CALIBRATE
+#define TM1637_CALIBRATE 0
+#endif
+
 #if __GNUC__ >= 3
 #define DEPRECATED          __attribute__((deprecated))
 #else
@@ -126,43 +148,105 @@ struct DisplayDigit {
 /**
  * @brief Facade to the underlying access to the display device
  * @details Wrapper to the low-level functions
+ * @tparam Bus Two-wire bus driving the device, see BasicMI2C
  */
-class TM1637 {
-    friend Animator;
+template<class Bus>
+class BasicTM1637 {
+    friend BasicAnimator<Bus>;
+    template<uint8_t> friend class TM1637Group;
 
 public:
+    using Animator = BasicAnimator<Bus>;
+
     static constexpr uint8_t TOTAL_DIGITS = 4;
 
+    static constexpr uint8_t NO_KEY = 0xFF;
+
+    /**
+     * @brief Batch lasting as long as the object, see `beginBatch()`
+     * @details `{ TM1637::Batch batch(tm); tm.display(1234); tm.colonOn(); tm.changeBrightness(5); }` sends one frame
+     */
+    class Batch {
+    public:
+        explicit Batch(BasicTM1637 &display) noexcept: display_(display) { display_.beginBatch(); }
+
+        Batch(const Batch &) = delete;
+
+        Batch &operator=(const Batch &) = delete;
+
+        ~Batch() { display_.commit(); }
+
+    private:
+        BasicTM1637 &display_;
+    };
+
     /**
      * @brief Construct a TM1637 Instance
      * @param clkPin Port number of the connected display CLK pin
      * @param dataPin Port number of the connected display DATA pin
      */
-    TM1637(uint8_t clkPin, uint8_t dataPin) noexcept: animator_(clkPin, dataPin, TOTAL_DIGITS) {};
+    BasicTM1637(uint8_t clkPin, uint8_t dataPin) noexcept: animator_(clkPin, dataPin, TOTAL_DIGITS) {
+        animator_.route(animated, this);
+    };
+
+    /**
+     * @brief Construct a TM1637 Instance whose pins are template parameters of the bus
+     */
+    BasicTM1637() noexcept: animator_(TOTAL_DIGITS) {
+        animator_.route(animated, this);
+    };
 
     /**
      * Deleted Copy Constructor
      */
-    TM1637(const TM1637 &) = delete;
+    BasicTM1637(const BasicTM1637 &) = delete;
 
     /**
      * Deleted Copy Assign Constructor
      */
-    TM1637 &operator=(const TM1637 &) = delete;
+    BasicTM1637 &operator=(const BasicTM1637 &) = delete;
 
     /**
      * Default Destructor
      */
-    ~TM1637() = default;
+    ~BasicTM1637() = default;
 
     /**
      * Initialise the low-level communication with the display device
      */
     void begin() {
         animator_.mi2C_.begin();
+#if TM1637_CALIBRATE
+        animator_.mi2C_.calibrate();
+#endif
+        animator_.invalidate();
         offMode();
     };
 
+    /**
+     * @brief Find the shortest bit delay this display reliably handles, starting from the current one
+     * @details Probes the display with shorter and shorter delays until it stops acknowledging, then keeps
+     * TM1637_CALIBRATION_MARGIN microseconds more. The next refresh resends every digit. Done by `begin()` with
+     * TM1637_CALIBRATE. StaticTM1637 keeps its compile-time delay
+     * @return Bit delay kept, in microseconds
+     */
+    uint8_t calibrate() noexcept {
+        auto delay = animator_.mi2C_.calibrate();
+        animator_.invalidate();
+        return delay;
+    }
+
+    /**
+     * @return Delay between the clock edges of this display, in microseconds
+     */
+    inline uint8_t getBitDelay() const noexcept { return animator_.mi2C_.getBitDelay(); }
+
+    /**
+     * @brief Change the delay between the clock edges of this display only. No effect on StaticTM1637
+     * @param delay Delay in microseconds, TM1637_DELAY by default
+     */
+    inline void setBitDelay(uint8_t delay) noexcept { animator_.mi2C_.setBitDelay(delay); }
+
     /**
      * Alias for `TM1637::begin()`
      */
@@ -173,12 +257,100 @@ public:
      * @return Current instance of the animator
      */
     inline Animator *refresh() {
+        pending_ = Animator::NO_CHANGE;
+        off_ = false;
+        if (frameInterval_)
+            stampFrame();
+        releaseNumber();
         animator_.refresh();
         return &animator_;
     }
 
+    /**
+     * @brief Limit how often the changes of the display are sent
+     * @details Changes coming sooner than 1/rate after the previous frame only update the display buffer. The latest
+     * state is sent by the first `update()` or change once the interval is over, so call `update()` from loop().
+     * `refresh()` still sends immediately
+     * @param rate Maximum number of frames per second, 0 for no limit
+     */
+    inline void setMaxFrameRate(uint16_t rate) noexcept {
+        frameInterval_ = rate ? 1000000ul / rate : 0;
+    }
+
+    /**
+     * @brief Hold back the changes of the display until `commit()`, which sends them all as a single frame
+     * @details Digits, colon, dots, brightness and on/off mode can be changed in any order: only the final state is
+     * sent. Batches nest, only the outermost `commit()` sends. `refresh()` still sends immediately
+     */
+    inline void beginBatch() noexcept { ++batch_; }
+
+    /**
+     * @brief Close a batch opened by `beginBatch()` and send what changed in it
+     * @return Current instance of the animator
+     */
+    Animator *commit() {
+        if (batch_ && --batch_)
+            return &animator_;
+        return apply(Animator::NO_CHANGE);
+    }
+
+    /**
+     * @brief Advance every running animation and send the result in at most one frame
+     * @details Call it from loop() once the animations are started, instead of calling `blink()`, `fadeIn()`, ...
+     * over and over. With a budget, a frame that would not fit in it, estimated from the duration of the previous
+     * frame of the same kind (content or control-only), is held back and sent by a later call. After
+     * TM1637_MAX_HOLDS calls in a row, it is sent even if it exceeds the budget, so the animations never freeze
+     * @param budget Maximum time to spend in microseconds, 0 for no limit
+     * @return Milliseconds until something has to be sent again: 0 if a frame is held back by the budget, the time
+     * left until the frame rate limit or the hold time lets held changes go, `Animator::NO_DEADLINE` if nothing is
+     * animated nor held
+     */
+    typename Animator::duration_type update(unsigned long budget = 0) {
+        auto begin = micros();
+        auto now = static_cast<typename Animator::duration_type>(millis());
+        pending_ |= animator_.advance(now);
+        if ((pending_ || off_) && !held()) {
+            // Control-only frames are much shorter than content frames: each kind has its own estimate
+            auto &estimate = (pending_ & Animator::CONTENT_CHANGE) ? frameTime_ : controlTime_;
+            if (!budget || micros() - begin + estimate <= budget || holds_ >= TM1637_MAX_HOLDS) {
+                auto sent = micros();
+                sendPending();
+                estimate = micros() - sent;
+                holds_ = 0;
+            } else {
+                ++holds_;
+                return 0;
+            }
+        }
+        const auto deadline = animator_.nextDeadline(now);
+        if (!pending_ && !off_)
+            return deadline;
+        const auto release = releaseIn();
+        return release < deadline ? release : deadline;
+    }
+
+#if TM1637_ASYNC
+    /**
+     * @brief Clock out the next step of the queued bus transfers. Call it from loop() or from a timer interrupt
+     * @return true while transfers are pending
+     */
+    inline bool poll() noexcept { return animator_.mi2C_.poll(); }
+
+    /**
+     * @return true while the last frames haven't been completely sent to the display
+     */
+    inline bool busy() const noexcept { return animator_.mi2C_.busy(); }
+
+    /**
+     * @brief Block until every queued transfer has been sent to the display
+     */
+    inline void flush() noexcept { animator_.mi2C_.flush(); }
+#endif
+
     /**
      * Print/Display some values on the display
+     * @details Numbers within the deadband of the number shown are ignored, numbers coming before its hold time is over
+     * are sent once it is, see `setDeadband()`
      * @param value Content to display
      * @param overflow Cache more characters than the display allows. Useful for scrolling
      * @param pad Fill the unoccupied 7-segments displays with 0
@@ -192,26 +364,72 @@ public:
             type_traits::is_integral<T>::value,
             Animator *>::type
     display(const T value, bool overflow = true, bool pad = false, uint8_t offset = 0) {
-        String temp = stringer<T>(value);
-        if (temp == cache_)
+        const uint8_t options = static_cast<uint8_t>(overflow | pad << 1u | offset << 2u);
+        const auto verdict = deadband(value, options);
+        if (verdict == IGNORE_NUMBER) {
+#if TM1637_STATS
+            ++animator_.stats_.skippedFrames;
+#endif
             return &animator_;
-        cache_ = temp;
-        String cache;
-        cache = "";
-        for (decltype(offset) counter{}; counter < offset; ++counter) {
-            cache.concat(static_cast<char>(0x00));
-        }
-        cache.concat(temp);
-        if (pad) {
-            for (size_t counter = cache.length(); counter < animator_.totalDigits_; ++counter) {
-                cache.concat(static_cast<char>('O'));
-            }
         }
-        if (!overflow) {
-            cache.substring(0, animator_.totalDigits_);
-        }
-        animator_.reset(cache);
-        return refresh();
+        startContent(offset);
+        encode(value);
+        holding_ = verdict == HOLD_NUMBER;
+        auto animator = endContent(overflow, pad);
+        remember(value, options);
+        return animator;
+    }
+
+    /**
+     * @brief Ignore the numbers passed to `display()` that barely differ from the number shown, or come too soon
+     * @details A number is only shown if it differs from the number shown by at least `band`: readings flickering
+     * between 23.4 and 23.5 then neither get formatted nor sent. A number coming less than `hold` milliseconds after
+     * the number shown is kept back, along with the other changes, and sent by the first `update()` or change once
+     * the hold time is over. Strings and the other calls are not affected, and a number following them is always shown
+     * @param band Smallest change shown, 0 to show every change
+     * @param hold Minimum time a number stays shown in milliseconds, 0 for none
+     */
+    inline void setDeadband(float band, uint16_t hold = 0) noexcept {
+        deadband_ = band;
+        hold_ = hold;
+    }
+
+    /**
+     * @brief Display a text encoded at compile time with `tm1637_lib::encode()`
+     * @details Nothing is encoded at runtime: the segment bytes are compared with the framebuffer and only sent if they
+     * changed
+     * @param segments Encoded text
+     * @param overflow Cache more characters than the display allows. Useful for scrolling
+     * @param pad Fill the unoccupied 7-segments displays with 0
+     * @param offset Start Position to display from
+     * @return Current instance of the animator
+     */
+    template<size_t N>
+    Animator *display(const tm1637_lib::Segments<N> &segments, bool overflow = true, bool pad = false,
+                      uint8_t offset = 0) {
+        startContent(offset);
+        for (size_t counter{}; counter < segments.size(); ++counter)
+            animator_.put(segments[counter]);
+        return endContent(overflow, pad);
+    }
+
+    /**
+     * @brief Display a fixed-point value without any floating point math
+     * @details `displayFixed(2345, 2)` shows "23.45". The decimal point is merged into the digit before it, like a
+     * '.' in a string
+     * @param mantissa Value scaled by 10^decimals
+     * @param decimals Number of digits after the decimal point
+     * @param overflow Cache more characters than the display allows. Useful for scrolling
+     * @param pad Fill the unoccupied 7-segments displays with 0
+     * @param offset Start Position to display from
+     * @return Current instance of the animator
+     */
+    template<typename T>
+    typename type_traits::enable_if<type_traits::is_integral<T>::value, Animator *>::type
+    displayFixed(const T mantissa, uint8_t decimals, bool overflow = true, bool pad = false, uint8_t offset = 0) {
+        startContent(offset);
+        tm1637_lib::detail::formatInteger(animator_, mantissa, decimals);
+        return endContent(overflow, pad);
     }
 
     /**
@@ -222,12 +440,14 @@ public:
      * @return Instance of the current animator
      */
     Animator *displayRawBytes(const uint8_t *buffer, size_t size) {
-        cache_ = "";
-        animator_.buffer_ = "";
+        cached_ = false;
+        holding_ = false;
+        animator_.rewind();
         for (decltype(size) counter{}; counter < size; ++counter) {
-            animator_.buffer_.concat(static_cast<char>(buffer[counter]));
+            animator_.put(buffer[counter]);
         }
-        return refresh();
+        animator_.finish();
+        return apply(Animator::CONTENT_CHANGE);
     }
 
     /**
@@ -235,8 +455,8 @@ public:
      * @return Instance of the current animator
      */
     inline Animator *offMode() noexcept {
-        animator_.off();
-        return &animator_;
+        off_ = true;
+        return apply(Animator::NO_CHANGE);
     };
 
     /**
@@ -244,8 +464,7 @@ public:
      * @return Instance of the current animator
      */
     inline Animator *onMode() noexcept {
-        animator_.on(animator_.brightness_);
-        return &animator_;
+        return apply(Animator::CONTROL_CHANGE);
     };
 
     /**
@@ -255,8 +474,7 @@ public:
      */
     inline Animator *colonOff() noexcept {
         animator_.colon_ = false;
-        animator_.refresh();
-        return &animator_;
+        return apply(Animator::CONTENT_CHANGE);
     };
 
     /**
@@ -266,8 +484,7 @@ public:
      */
     inline Animator *colonOn() noexcept {
         animator_.colon_ = true;
-        animator_.refresh();
-        return &animator_;
+        return apply(Animator::CONTENT_CHANGE);
     };
 
     /**
@@ -276,8 +493,7 @@ public:
      */
     inline Animator *switchColon() noexcept {
         animator_.colon_ = !animator_.colon_;
-        animator_.refresh();
-        return &animator_;
+        return apply(Animator::CONTENT_CHANGE);
     };
 
     /**
@@ -285,9 +501,10 @@ public:
      * @return Instance of the current animator
      */
     inline Animator *clearScreen() noexcept {
-        animator_.clear();
-        cache_ = "";
-        return refresh();
+        animator_.blank();
+        cached_ = false;
+        holding_ = false;
+        return apply(Animator::CONTENT_CHANGE);
     };
 
     /**
@@ -297,7 +514,7 @@ public:
      */
     inline Animator *setDp(uint8_t value) noexcept {
         animator_.dp_ = value;
-        return refresh();
+        return apply(Animator::CONTENT_CHANGE);
     }
 
     /**
@@ -320,7 +537,7 @@ public:
      */
     void changeBrightness(uint8_t value) noexcept {
         animator_.brightness_ = Animator::fetchControl(value);
-        refresh();
+        apply(Animator::CONTROL_CHANGE);
     };
 
     /**
@@ -351,7 +568,7 @@ public:
      */
     inline Animator *changeBrightnessPercent(float percent) noexcept {
         animator_.brightness_ = Animator::fetchControlPercent(percent);
-        return refresh();
+        return apply(Animator::CONTROL_CHANGE);
     }
 
     /**
@@ -360,28 +577,323 @@ public:
      */
     inline void setFloatDigitCount(unsigned count) {
         floatDecimal_ = count;
+        numeric_ = false;
     }
 
+    /**
+     * @brief Read the key scan code from the display device right away
+     * @return Raw code as sent by the device, 0xFF when no key is pressed
+     */
+    inline uint8_t readKeyCode() noexcept {
+        // The read command replaces the data command the device holds
+        animator_.dataShadow_ = 0;
+        return animator_.mi2C_.read(static_cast<uint8_t>(Animator::DataCommand_e::READ_KEY_SCAN_DATA));
+    }
+
+    /**
+     * @brief Scan the keys if the scan interval elapsed, and debounce the result
+     * @details Call it from loop(). A scan is a single short transaction, so it can be freely interleaved with
+     * display updates
+     * @return true if the debounced key changed, see `getKey()`
+     */
+    bool scanKeys() noexcept {
+        auto now = millis();
+        if (scanned_ && now - lastScan_ < keyInterval_)
+            return false;
+        scanned_ = true;
+        lastScan_ = now;
+        auto key = keyIndex(readKeyCode());
+        if (key != candidate_) {
+            candidate_ = key;
+            samples_ = 0;
+        }
+        if (samples_ < keyDebounce_)
+            ++samples_;
+        if (samples_ < keyDebounce_ || key == key_)
+            return false;
+        key_ = key;
+        return true;
+    }
+
+    /**
+     * @brief Get the debounced key, updated by `scanKeys()`
+     * @return Key index: 0 to 7 for SG1 to SG8 on K1, 8 to 15 for SG1 to SG8 on K2. `NO_KEY` if no key is pressed
+     */
+    inline uint8_t getKey() const noexcept { return key_; }
+
+    /**
+     * @brief Configure `scanKeys()`
+     * @param interval Minimum duration between two scans in milliseconds
+     * @param debounce Number of identical consecutive scans before a key change is accepted
+     */
+    inline void setKeyScan(uint16_t interval, uint8_t debounce = TM1637_KEY_DEBOUNCE) noexcept {
+        keyInterval_ = interval;
+        keyDebounce_ = debounce ? debounce : 1;
+    }
+
+    /**
+     * @brief Convert a raw key scan code into a key index
+     * @param code Code as returned by `readKeyCode()`
+     * @return Key index as returned by `getKey()`
+     */
+    static uint8_t keyIndex(uint8_t code) noexcept {
+        uint8_t segment = static_cast<uint8_t>(7u - (code & 0x07u));
+        switch (code & 0x18u) {
+            case 0x10u:
+                return segment;
+            case 0x08u:
+                return static_cast<uint8_t>(8u + segment);
+            default:
+                return NO_KEY;
+        }
+    }
+
+    /**
+     * @brief Get the number of frames the display did not acknowledge, even after TM1637_RETRIES retries
+     * @details Each failed frame leaves the display marked as unknown, so the next refresh resends every digit. Always 0
+     * with TM1637_ASYNC, where the ACKs are not read back
+     */
+    inline uint16_t getFailures() const noexcept { return animator_.failures_; }
+
+#if TM1637_STATS
+    /**
+     * @brief Get the bus traffic of the display
+     * @return Counters since the display was created or since the last `resetStatistics()`
+     */
+    inline const tm1637_lib::Statistics &getStatistics() const noexcept { return animator_.stats_; }
+
+    /**
+     * @brief Reset every counter of `getStatistics()` to 0
+     */
+    inline void resetStatistics() noexcept { animator_.stats_ = tm1637_lib::Statistics{}; }
+#endif
+
 private:
+    // What display() does with a value, see `setDeadband()`
+    enum Deadband_e : uint8_t {
+        SHOW_NUMBER,
+        IGNORE_NUMBER,                  // Within the deadband of the number shown
+        HOLD_NUMBER                     // Shown once the hold time of the number shown is over
+    };
+
+    template<typename T>
+    typename type_traits::enable_if<!type_traits::is_string<T>::value, Deadband_e>::type
+    deadband(T value, uint8_t options) const noexcept {
+        if (!numeric_ || !cached_ || options != options_ || (deadband_ <= 0 && !hold_))
+            return SHOW_NUMBER;
+        const float number = static_cast<float>(value);
+        const float delta = number > shown_ ? number - shown_ : shown_ - number;
+        if (delta == 0 || delta < deadband_)
+            return IGNORE_NUMBER;
+        return millis() - shownAt_ < hold_ ? HOLD_NUMBER : SHOW_NUMBER;
+    }
+
+    template<typename T>
+    typename type_traits::enable_if<type_traits::is_string<T>::value, Deadband_e>::type
+    deadband(const T &, uint8_t) const noexcept {
+        return SHOW_NUMBER;
+    }
+
+    template<typename T>
+    typename type_traits::enable_if<!type_traits::is_string<T>::value>::type
+    remember(T value, uint8_t options) noexcept {
+        if (deadband_ <= 0 && !hold_)
+            return;
+        numeric_ = true;
+        options_ = options;
+        shown_ = static_cast<float>(value);
+        // A number kept back starts its hold time when it is sent
+        if (!holding_)
+            shownAt_ = millis();
+    }
+
+    /**
+     * @brief Start the hold time of a number kept back, now that it is sent
+     */
+    inline void releaseNumber() noexcept {
+        if (holding_) {
+            holding_ = false;
+            shownAt_ = millis();
+        }
+    }
+
     template<typename T>
-    typename type_traits::enable_if<type_traits::is_string<T>::value, String>::type stringer(T value) {
-        return value;
+    typename type_traits::enable_if<type_traits::is_string<T>::value>::type remember(const T &, uint8_t) noexcept {}
+
+    void startContent(uint8_t offset) {
+        numeric_ = false;
+        holding_ = false;
+        animator_.rewind();
+        for (decltype(offset) counter{}; counter < offset; ++counter)
+            animator_.put(0x00);
+    }
+
+    Animator *endContent(bool overflow, bool pad) {
+        if (pad) {
+            for (size_t counter = animator_.cursor_; counter < animator_.totalDigits_; ++counter)
+                animator_.append('O');
+        }
+        if (!overflow && animator_.cursor_ > animator_.totalDigits_)
+            animator_.cursor_ = animator_.totalDigits_;
+        if (!animator_.finish() && cached_) {
+#if TM1637_STATS
+            ++animator_.stats_.skippedFrames;
+#endif
+            return &animator_;
+        }
+        cached_ = true;
+        return apply(Animator::CONTENT_CHANGE);
+    }
+
+    /**
+     * @brief Changes of the animations run through the animator, e.g. `tm.display(1234)->blink(500)`
+     */
+    static void animated(void *self, uint8_t changes) {
+        static_cast<BasicTM1637 *>(self)->apply(changes);
+    }
+
+    /**
+     * @brief Send a change of the display, or keep it for `commit()` while a batch is open
+     * @param changes Animator::Change_e flags. Any change turns the display back on, like it always did
+     */
+    Animator *apply(uint8_t changes) {
+        if (changes)
+            off_ = false;
+        pending_ |= changes;
+        return held() ? &animator_ : sendPending();
+    }
+
+    /**
+     * @return true while the changes have to be kept back: a batch is open, the frame rate limit is reached or a
+     * number waits for the hold time of the number shown
+     */
+    inline bool held() const noexcept {
+        return batch_ || (framed_ && micros() - lastFrame_ < frameInterval_) ||
+               (holding_ && millis() - shownAt_ < hold_);
+    }
+
+    /**
+     * @return Milliseconds until `held()` lets the changes go, `Animator::NO_DEADLINE` while a batch is open
+     */
+    typename Animator::duration_type releaseIn() const noexcept {
+        using duration_type = typename Animator::duration_type;
+        duration_type wait = batch_ ? static_cast<duration_type>(Animator::NO_DEADLINE) : 0;
+        if (framed_) {
+            const unsigned long elapsed = micros() - lastFrame_;
+            const unsigned long left = elapsed < frameInterval_ ? (frameInterval_ - elapsed + 999) / 1000 : 0;
+            if (left > wait)
+                wait = static_cast<duration_type>(left);
+        }
+        if (holding_) {
+            const unsigned long elapsed = millis() - shownAt_;
+            const unsigned long left = elapsed < hold_ ? hold_ - elapsed : 0;
+            if (left > wait)
+                wait = static_cast<duration_type>(left);
+        }
+        return wait;
+    }
+
+    /**
+     * @brief Start the frame rate limit from the frame being sent. Before the first one there is nothing to limit
+     */
+    inline void stampFrame() noexcept {
+        lastFrame_ = micros();
+        framed_ = true;
+    }
+
+    /**
+     * @brief Send the changes kept so far: the frame if the digits changed, the display control otherwise
+     */
+    Animator *sendPending() {
+        if (frameInterval_ && (pending_ || off_))
+            stampFrame();
+        releaseNumber();
+        animator_.sendChanges(pending_);
+        if (off_)
+            animator_.off();
+        pending_ = Animator::NO_CHANGE;
+        off_ = false;
+        return &animator_;
+    }
+
+    void encode(char value) {
+        animator_.append(value);
+    }
+
+    void encode(const char *value) {
+        while (*value)
+            animator_.append(*value++);
+    }
+
+    void encode(const __FlashStringHelper *value) {
+        auto text = reinterpret_cast<const char *>(value);
+        for (char c; (c = static_cast<char>(pgm_read_byte(text))); ++text)
+            animator_.append(c);
+    }
+
+    void encode(const String &value) {
+        for (decltype(value.length()) counter{}; counter < value.length(); ++counter)
+            animator_.append(value[counter]);
     }
 
     template<typename T>
-    typename type_traits::enable_if<type_traits::is_integral<T>::value, String>::type stringer(T value) {
-        return String(value);
+    typename type_traits::enable_if<type_traits::is_integral<T>::value>::type encode(T value) {
+        tm1637_lib::detail::formatInteger(animator_, value);
     }
 
     template<typename T>
-    typename type_traits::enable_if<type_traits::is_floating_point<T>::value, String>::type stringer(T value) {
-        return String(value, static_cast<unsigned>(floatDecimal_));
+    typename type_traits::enable_if<type_traits::is_floating_point<T>::value>::type encode(T value) {
+        tm1637_lib::detail::formatFloat(animator_, value, static_cast<uint8_t>(floatDecimal_));
     }
 
 private:
     Animator animator_;
-    String cache_ = "";
+    bool cached_ = false;
     unsigned floatDecimal_ = TOTAL_DIGITS;
+    unsigned long frameTime_{};
+    unsigned long controlTime_{};
+    uint8_t holds_{};
+    uint8_t pending_{};
+    uint8_t batch_{};
+    float deadband_{};
+    uint16_t hold_{};
+    bool numeric_{};
+    uint8_t options_{};
+    float shown_{};
+    uint32_t shownAt_{};
+    bool holding_{};
+    unsigned long frameInterval_{};
+    unsigned long lastFrame_{};
+    bool framed_{};
+    bool off_{};
+    uint32_t lastScan_{};
+    uint16_t keyInterval_ = TM1637_KEY_SCAN_INTERVAL;
+    uint8_t keyDebounce_ = TM1637_KEY_DEBOUNCE;
+    uint8_t candidate_ = NO_KEY;
+    uint8_t samples_{};
+    uint8_t key_ = NO_KEY;
+    bool scanned_{};
 };
 
+template<class Bus>
+constexpr uint8_t BasicTM1637<Bus>::TOTAL_DIGITS;
+
+template<class Bus>
+constexpr uint8_t BasicTM1637<Bus>::NO_KEY;
+
+/**
+ * @brief Display driven through pins given at runtime
+ */
+using TM1637 = BasicTM1637<MI2C>;
+
+/**
+ * @brief Display whose pins (and bit delay) are template parameters. The whole transfer compiles down to direct port
+ * writes and no pin data is kept in RAM
+ * @code
+ * StaticTM1637<2, 3> tm;
+ * @endcode
+ */
+template<uint8_t CLK_PIN, uint8_t DATA_PIN, unsigned DELAY = TM1637_DELAY>
+using StaticTM1637 = BasicTM1637<StaticMI2C<CLK_PIN, DATA_PIN, DELAY>>;
+
 #endif //TM1637_TM1637_H
@@ -0,0 +1,252 @@
+#ifndef TM1637_TM1637GROUP_H
+#define TM1637_TM1637GROUP_H
+
+#include <Arduino.h>
+#include "TM1637.h"
+
+namespace tm1637_lib
+{
+namespace detail
+{
+    /**
+     * @brief Bus of a display that belongs to a TM1637Group
+     * @details Nothing is clocked out: the commands are decoded into an image of the device registers, which the group
+     * then sends to every device at once
+     */
+    class RegisterImage
+    {
+    public:
+        static constexpr uint8_t TOTAL_REGISTERS = 6;
+
+        void begin() noexcept
+        {}
+
+        void beginTransmission() const noexcept
+        {
+            first_ = true;
+        }
+
+        void endTransmission() const noexcept
+        {}
+
+        // Never NAKs: the group retries and recovers the shared bus itself, see TM1637Group::refresh()
+        void recover() const noexcept
+        {}
+
+        uint8_t calibrate() noexcept
+        {
+            return 0;
+        }
+
+        uint8_t send(uint8_t value) const noexcept
+        {
+            if (!first_) {
+                if (address_ < TOTAL_REGISTERS) {
+                    registers_[address_] = value;
+                    written_ |= static_cast<uint8_t>(1u << address_);
+                }
+                if (!(dataCommand_ & 0x04u))
+                    ++address_;
+                return 0;
+            }
+            first_ = false;
+            switch (value & 0xC0u) {
+                case 0x40u:
+                    dataCommand_ = value;
+                    break;
+                case 0xC0u:
+                    address_ = static_cast<uint8_t>(value & 0x07u);
+                    break;
+                case 0x80u:
+                    control_ = value;
+                    break;
+                default:
+                    break;
+            }
+            return 0;
+        }
+
+        inline uint8_t reg(uint8_t address) const noexcept { return registers_[address]; }
+
+        inline uint8_t control() const noexcept { return control_; }
+
+        /**
+         * @return Registers written so far, one bit per register
+         */
+        inline uint8_t written() const noexcept { return written_; }
+
+    private:
+        mutable uint8_t registers_[TOTAL_REGISTERS]{};
+        mutable uint8_t written_{};
+        mutable uint8_t control_ = 0x80;
+        mutable uint8_t dataCommand_ = 0x40;
+        mutable uint8_t address_{};
+        mutable bool first_{};
+    };
+}
+}
+
+/**
+ * @brief Several displays sharing one CLK line, each with its own DIO line
+ * @details Every display is driven through the usual TM1637 interface, `group[index]`, but nothing is sent until
+ * `refresh()`, which clocks the changed digits and display controls of all the displays at the same time: one
+ * frame costs about as much for eight displays as for one. Put the DIO pins on the same port to get there, see
+ * ParallelMI2C
+ * @tparam SIZE Number of displays, at most 8
+ */
+template<uint8_t SIZE>
+class TM1637Group {
+public:
+    using Display = BasicTM1637<tm1637_lib::detail::RegisterImage>;
+
+    /**
+     * @param clkPin Clock pin shared by every display
+     * @param dataPins Data pin of each display
+     */
+    TM1637Group(uint8_t clkPin, const uint8_t (&dataPins)[SIZE]) noexcept: bus_(clkPin, dataPins) {}
+
+    TM1637Group(const TM1637Group &) = delete;
+
+    TM1637Group &operator=(const TM1637Group &) = delete;
+
+    ~TM1637Group() = default;
+
+    /**
+     * Initialise the bus and turn every display off
+     */
+    void begin() {
+        bus_.begin();
+        for (auto &display : displays_)
+            display.begin();
+        invalidate();
+        refresh();
+    }
+
+    /**
+     * @brief Access a display of the group. Its changes are sent on the next `refresh()`
+     * @param index Position of the display's data pin in the constructor's list
+     */
+    inline Display &operator[](uint8_t index) noexcept { return displays_[index]; }
+
+    inline const Display &operator[](uint8_t index) const noexcept { return displays_[index]; }
+
+    static constexpr uint8_t size() noexcept { return SIZE; }
+
+    /**
+     * @brief Send the changes of every display at the same time
+     * @details The span from the first to the last digit changed on any display is sent as one
+     * `AUTOMATIC_ADDRESS_ADDING` burst, followed by the display control of each display if any of them changed. Like
+     * a single display, a frame a display did not acknowledge is sent again up to TM1637_RETRIES times after
+     * recovering the bus, with all the digits of that display since what it holds is unknown
+     * @return Displays that did not acknowledge the last attempt, one bit per display. They get all their digits
+     * again on the next refresh
+     */
+    uint8_t refresh() noexcept {
+        uint8_t NAK = sendFrame();
+        for (uint8_t attempt = 0; NAK; ++attempt) {
+            bus_.recover();
+            forget(NAK);
+            if (attempt == TM1637_RETRIES)
+                break;
+            NAK = sendFrame();
+        }
+        return NAK;
+    }
+
+    /**
+     * @brief Forget what the displays hold, so the next refresh resends every digit and display control
+     */
+    inline void invalidate() noexcept {
+        forget(ALL_DISPLAYS);
+    }
+
+private:
+    static constexpr uint8_t REGISTERS = tm1637_lib::detail::RegisterImage::TOTAL_REGISTERS;
+    static constexpr uint8_t ALL_DISPLAYS = ParallelMI2C<SIZE>::ALL_LANES;
+
+    /**
+     * @return Displays that did not acknowledge, one bit per display
+     */
+    uint8_t sendFrame() noexcept {
+        uint8_t first = REGISTERS, last = 0, NAK = 0;
+        for (uint8_t address = 0; address < REGISTERS; ++address) {
+            for (uint8_t index = 0; index < SIZE; ++index) {
+                if (!changed(index, address))
+                    continue;
+                if (first == REGISTERS)
+                    first = address;
+                last = address;
+            }
+        }
+        uint8_t values[SIZE];
+        if (first != REGISTERS) {
+            bus_.beginTransmission();
+            NAK |= bus_.send(static_cast<uint8_t>(Display::Animator::DataCommand_e::AUTOMATIC_ADDRESS_ADDING));
+            bus_.endTransmission();
+            bus_.beginTransmission();
+            NAK |= bus_.send(static_cast<uint8_t>(static_cast<uint8_t>(Display::Animator::AddressCommand_e::C0H) + first));
+            for (auto address = first; address <= last; ++address) {
+                for (uint8_t index = 0; index < SIZE; ++index) {
+                    values[index] = image(index).reg(address);
+                    shadow_[index][address] = values[index];
+                }
+                NAK |= bus_.send(values);
+            }
+            bus_.endTransmission();
+            const auto sent = static_cast<uint8_t>(((1u << (last + 1)) - 1u) & ~((1u << first) - 1u));
+            for (uint8_t index = 0; index < SIZE; ++index)
+                shadowed_[index] |= sent;
+        }
+        bool controlChanged = !controlShadowed_;
+        for (uint8_t index = 0; index < SIZE; ++index) {
+            values[index] = image(index).control();
+            controlChanged |= values[index] != controlShadow_[index];
+        }
+        if (controlChanged) {
+            bus_.beginTransmission();
+            NAK |= bus_.send(values);
+            bus_.endTransmission();
+            for (uint8_t index = 0; index < SIZE; ++index)
+                controlShadow_[index] = values[index];
+            controlShadowed_ = true;
+        }
+        return NAK;
+    }
+
+    /**
+     * @brief Make the next frame resend every digit of the given displays, and the display controls
+     * @param displays One bit per display
+     */
+    inline void forget(uint8_t displays) noexcept {
+        for (uint8_t index = 0; index < SIZE; ++index) {
+            if (displays & (1u << index))
+                shadowed_[index] = 0;
+        }
+        controlShadowed_ = false;
+    }
+
+    inline const tm1637_lib::detail::RegisterImage &image(uint8_t index) const noexcept {
+        return displays_[index].animator_.mi2C_;
+    }
+
+    inline bool changed(uint8_t index, uint8_t address) const noexcept {
+        if (!(image(index).written() & (1u << address)))
+            return false;
+        return !(shadowed_[index] & (1u << address)) || shadow_[index][address] != image(index).reg(address);
+    }
+
+    ParallelMI2C<SIZE> bus_;
+    Display displays_[SIZE];
+    uint8_t shadow_[SIZE][REGISTERS]{};
+    uint8_t shadowed_[SIZE]{};
+    uint8_t controlShadow_[SIZE]{};
+    bool controlShadowed_{};
+};
+
+template<uint8_t SIZE>
+constexpr uint8_t TM1637Group<SIZE>::REGISTERS;
+
+template<uint8_t SIZE>
+constexpr uint8_t TM1637Group<SIZE>::ALL_DISPLAYS;
+
+#endif //TM1637_TM1637GROUP_H
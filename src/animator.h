@@ -4,9 +4,23 @@
 #include <Arduino.h>
 #include "type_traits.h"
 #include "mI2C.h"
+#include "framebuffer.h"
+#include "font.h"
+#include "statistics.h"
 
+// Times a frame the device did not acknowledge is sent again, after recovering the bus, before it is given up
+#ifndef TM1637_RETRIES
+#define TM1637_RETRIES 2
+#endif
 
-class Animator {
+template<uint8_t> class TM1637Group;
+
+/**
+ * @brief Display buffer and animations of a display device
+ * @tparam Bus Two-wire bus driving the device, see BasicMI2C
+ */
+template<class Bus>
+class BasicAnimator {
     struct Tasker {
         using duration_type = uint32_t;
 
@@ -16,7 +30,10 @@ class Animator {
         }
 
         bool check() {
-            auto current = millis();
+            return check(millis());
+        }
+
+        bool check(duration_type current) {
             if (current - start_ > delay_) {
                 start_ = current;
                 return true;
@@ -24,12 +41,31 @@ class Animator {
             return false;
         }
 
+        /**
+         * @return Time left until `check()` succeeds, 0 if it already does
+         */
+        duration_type remaining(duration_type current) const {
+            auto elapsed = current - start_;
+            return elapsed > delay_ ? 0 : delay_ - elapsed + 1;
+        }
+
     private:
         duration_type delay_;
         duration_type start_;
     };
 
-    friend class TM1637;
+    /**
+     * @brief State of one running animation
+     */
+    struct Track {
+        Tasker tasker;
+        uint16_t position;
+        uint8_t mode;
+        bool running;
+    };
+
+    template<class> friend class BasicTM1637;
+    template<uint8_t> friend class TM1637Group;
 
     enum class DataCommand_e : uint8_t {
         FIXED_ADDRESS = 0x44,
@@ -50,15 +86,57 @@ class Animator {
         C6H                             // Ignore scan
     };
 
-    enum class Animation : int8_t {
-        NONE,
-        BLINK,
+    // Animations on different tracks run at the same time, starting an animation replaces the one on its track
+    enum Track_e : uint8_t {
+        BLINK_TRACK,
+        FADE_TRACK,
+        SCROLL_TRACK,
+        TOTAL_TRACKS
+    };
+
+    enum Fade_e : uint8_t {
         FADE_OUT,
-        FADE_IN,
-        SCROLL_LEFT
+        FADE_IN
+    };
+
+    // What an animation step changed, hence what has to be sent to the display
+    enum Change_e : uint8_t {
+        NO_CHANGE,
+        CONTROL_CHANGE,                 // Only the display control: brightness or blanking
+        CONTENT_CHANGE                  // The digits
     };
 
+    // Set in the mode of a bouncing scroll while it moves back to the start
+    static constexpr uint8_t BOUNCE_BACK = 0x80;
+
+    // Mode of the scroll track while it shows characters pulled from a stream source
+    static constexpr uint8_t STREAM_MODE = 0x10;
+
+    // Look-ahead value meaning that no character has been read ahead
+    static constexpr int NO_CHARACTER = -2;
+
 public:
+    enum class ScrollMode_e : uint8_t {
+        LEFT,                           // Move the content out to the left, once
+        RIGHT,                          // Move the content out to the right, once
+        MARQUEE,                        // Move to the left and wrap around, forever
+        BOUNCE                          // Move left and right so that every digit gets shown, forever
+    };
+
+    /**
+     * @brief Source of a streamed text
+     * @param context Pointer given along with the source
+     * @return Next character, negative at the end of the text or if nothing is available yet
+     */
+    using source_type = int (*)(void *context);
+
+    /**
+     * @brief Receiver of the changes made by the animations that `tick()` runs, instead of sending them
+     * @param context Pointer given along with the sink
+     * @param changes Change_e flags
+     */
+    using sink_type = void (*)(void *context, uint8_t changes);
+
     enum class DisplayControl_e : uint8_t {
         PULSE_WIDTH_1_16 = 0x88,
         PULSE_WIDTH_2_16,
@@ -72,105 +150,173 @@ public:
         DISPLAY_ON = PULSE_WIDTH_1_16
     };
 
+    using duration_type = typename Tasker::duration_type;
+
+    static constexpr duration_type NO_DEADLINE = 0xFFFFFFFFul;
+
     /**
      * @brief Construct an animator object to manage the low-level transfer to the display device
      * @param clkPin Port number of the Clock pin
      * @param dataPin Port number of the Data pin
      * @param totalDigits Total number of digits the device supports
      */
-    Animator(uint8_t clkPin, uint8_t dataPin, uint8_t totalDigits) : mi2C_(clkPin, dataPin),
-                                                                     totalDigits_{totalDigits} {}
+    BasicAnimator(uint8_t clkPin, uint8_t dataPin, uint8_t totalDigits) : mi2C_(clkPin, dataPin),
+                                                                          totalDigits_{totalDigits} {}
+
+    /**
+     * @brief Construct an animator object for a bus whose pins are known at compile time
+     * @param totalDigits Total number of digits the device supports
+     */
+    explicit BasicAnimator(uint8_t totalDigits) : totalDigits_{totalDigits} {}
 
     /**
      * @brief Run the blinking animation in periodic intervals
-     * @param delay Duration in-between animations in seconds
-     */
-    void blink(Tasker::duration_type delay) {
-        static DisplayControl_e savedBrightness;
-        if (currentAnimation == Animation::BLINK) {
-            if (tasker.check()) {
-                brightness_ =
-                        brightness_ != DisplayControl_e::DISPLAY_OFF ? DisplayControl_e::DISPLAY_OFF : savedBrightness;
-                refresh();
-            }
-            return;
-        }
-        savedBrightness = brightness_;
-        tasker.reset(delay, millis());
-        currentAnimation = Animation::BLINK;
+     * @details The first call starts the animation, the next ones run all the due animations like `tick()`
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void blink(duration_type delay) {
+        if (!tracks_[BLINK_TRACK].running)
+            start(BLINK_TRACK, delay, 0);
+        tick();
     }
 
     /**
-     * @brief Run the fade-out animation in periodic intervals
-     * @param delay Duration in-between animations in seconds
+     * @brief Run the fade-out animation in periodic intervals. Replaces a running fade-in
+     * @param delay Duration in-between animations in milliseconds
      */
-    void fadeOut(Tasker::duration_type delay) {
-        if (currentAnimation == Animation::FADE_OUT) {
-            if (tasker.check()) {
-                auto current = control2Int(brightness_);
-                if (current > 0) --current;
-                brightness_ = fetchControl(current);
-                refresh();
-            }
-            return;
-        }
-        tasker.reset(delay, millis());
-        currentAnimation = Animation::FADE_OUT;
+    void fadeOut(duration_type delay) {
+        fade(FADE_OUT, delay);
     }
 
     /**
-     * @brief Run the fade-in animation in periodic intervals
-     * @param delay Duration in-between animations in seconds
+     * @brief Run the fade-in animation in periodic intervals. Replaces a running fade-out
+     * @param delay Duration in-between animations in milliseconds
      */
-    void fadeIn(Tasker::duration_type delay) {
-        if (currentAnimation == Animation::FADE_IN) {
-            if (tasker.check()) {
-                if (brightness_ == DisplayControl_e::PULSE_WIDTH_14_16)
-                    return;
-                auto current = control2Int(brightness_);
-                current++;
-                brightness_ = fetchControl(current);
-                refresh();
-            }
-            return;
-        }
-        tasker.reset(delay, millis());
-        currentAnimation = Animation::FADE_IN;
+    void fadeIn(duration_type delay) {
+        fade(FADE_IN, delay);
     }
 
     /**
      * @brief Run the scroll-left animation in periodic intervals
-     * @param delay Duration in-between animations in seconds
-     */
-    void scrollLeft(Tasker::duration_type delay) {
-        if (currentAnimation == Animation::SCROLL_LEFT) {
-            if (tasker.check()) {
-                static unsigned int index = 0;
-                if (index > buffer_.length()) {
-                    currentAnimation = Animation::NONE;
-                    index = 0;
-                    return;
-                }
-                String s(buffer_.substring(index, buffer_.length()));
-                ++index;
-                for (size_t counter = s.length(); counter < totalDigits_; ++counter)
-                    s.concat(static_cast<char>(0x00));
-                sendToDisplay<DataCommand_e::AUTOMATIC_ADDRESS_ADDING, AddressCommand_e::C0H>(
-                        brightness_,
-                        reinterpret_cast<const uint8_t *>(s.c_str()),
-                        static_cast<size_t>(min((unsigned int) totalDigits_, s.length())));
-            }
-            return;
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void scrollLeft(duration_type delay) {
+        scroll(ScrollMode_e::LEFT, delay);
+    }
+
+    /**
+     * @brief Run the scroll-right animation in periodic intervals
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void scrollRight(duration_type delay) {
+        scroll(ScrollMode_e::RIGHT, delay);
+    }
+
+    /**
+     * @brief Scroll the content to the left forever, wrapping around after a blank screen
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void marquee(duration_type delay) {
+        scroll(ScrollMode_e::MARQUEE, delay);
+    }
+
+    /**
+     * @brief Scroll content longer than the display back and forth
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void bounce(duration_type delay) {
+        scroll(ScrollMode_e::BOUNCE, delay);
+    }
+
+    /**
+     * @brief Run a scroll animation in periodic intervals. Replaces a running scroll of another mode
+     * @details The display shows a window sliding over the data buffer: nothing is copied and nothing is allocated
+     * @param mode Direction and behaviour at the end of the content
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void scroll(ScrollMode_e mode, duration_type delay) {
+        const Track &track = tracks_[SCROLL_TRACK];
+        if (!track.running || (track.mode & ~BOUNCE_BACK) != static_cast<uint8_t>(mode))
+            start(SCROLL_TRACK, delay, static_cast<uint8_t>(mode));
+        tick();
+    }
+
+    /**
+     * @brief Scroll a text of any length to the left, pulling its characters on demand
+     * @details Only a window of the display's size is kept in memory: the characters are encoded as they enter it.
+     * The animation stops once the end of the text has left the display. The first call starts the animation, the
+     * next ones with the same source run all the due animations like `tick()`
+     * @param source Function returning the next character
+     * @param context Passed to every call of the source
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void stream(source_type source, void *context, duration_type delay) {
+        stream(source, context, delay, false);
+    }
+
+    /**
+     * @brief Scroll the characters read from a Stream, e.g. Serial, to the left
+     * @details Runs until `resetAnimation()`: while the stream has nothing to read, blank digits scroll in
+     * @param source Stream to read from
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void stream(Stream &source, duration_type delay) {
+        stream(readStream, &source, delay, true);
+    }
+
+    /**
+     * @brief Scroll a text stored in program memory to the left, without copying it to RAM
+     * @param text Text, e.g. `F("HELLO")`
+     * @param delay Duration in-between animations in milliseconds
+     */
+    void stream(const __FlashStringHelper *text, duration_type delay) {
+        if (!streaming() || source_ != readFlash || flashText_ != text) {
+            flashText_ = text;
+            flashCursor_ = reinterpret_cast<const char *>(text);
+        }
+        stream(readFlash, this, delay, false);
+    }
+
+    /**
+     * @brief Run every animation that is due and send the result to the display in a single transfer
+     * @details The animator of a BasicTM1637 hands the result to it instead: like its other changes, the frame is
+     * kept back while a batch is open or the frame rate limit is reached, and sent by a later `tick()` or `update()`
+     * @return Milliseconds until the next animation step, `NO_DEADLINE` if no animation is running. Nothing needs to
+     * be sent to the display before then
+     */
+    duration_type tick() {
+        auto now = static_cast<duration_type>(millis());
+        auto changes = advance(now);
+        if (sink_)
+            sink_(sinkContext_, changes);
+        else
+            sendChanges(changes);
+        return nextDeadline(now);
+    }
+
+    /**
+     * @return Milliseconds until the next animation step, `NO_DEADLINE` if no animation is running
+     */
+    duration_type nextDeadline() const {
+        return nextDeadline(static_cast<duration_type>(millis()));
+    }
+
+    /**
+     * @return true while at least one animation is running
+     */
+    bool animating() const noexcept {
+        for (const auto &track : tracks_) {
+            if (track.running)
+                return true;
         }
-        tasker.reset(delay, millis());
-        currentAnimation = Animation::SCROLL_LEFT;
+        return false;
     }
 
     /**
      * @brief Turn the display off but keep the internal cache and data intact.
      */
     void off() const {
-        sendToDisplay<DataCommand_e::FIXED_ADDRESS, AddressCommand_e::C6H>(DisplayControl_e::DISPLAY_OFF);
+        sendToDisplay(DisplayControl_e::DISPLAY_OFF);
     }
 
     /**
@@ -178,7 +324,14 @@ public:
      * @param brightness Pulse frequency equivalent to the brightness of the device
      */
     void on(DisplayControl_e brightness) const {
-        sendToDisplay<DataCommand_e::FIXED_ADDRESS, AddressCommand_e::C6H>(brightness);
+        sendToDisplay(brightness);
+    }
+
+    /**
+     * @brief Send the current brightness, or the blanking of a blink, without touching the digits
+     */
+    void refreshControl() const {
+        sendToDisplay(blanked_ ? DisplayControl_e::DISPLAY_OFF : brightness_);
     }
 
     /**
@@ -186,21 +339,92 @@ public:
      * @param value Buffer to fill the display's buffer with
      */
     void reset(const String &value) {
-        buffer_ = "";
-        for (decltype(value.length()) counter{}; counter < value.length(); ++counter) {
-            auto d = toDisplayDigit(value[counter]);
-            if (d == 0x80u && buffer_.length() > 0) {
-                buffer_[buffer_.length() - 1] |= static_cast<char>(0x80u);
-            } else
-                buffer_.concat(static_cast<char>(d));
+        rewind();
+        for (decltype(value.length()) counter{}; counter < value.length(); ++counter)
+            append(value[counter]);
+        finish();
+    }
+
+    /**
+     * @brief Reset, refill the data buffer of the display
+     * @param value Null-terminated characters to fill the display's buffer with
+     */
+    void reset(const char *value) {
+        rewind();
+        while (*value)
+            append(*value++);
+        finish();
+    }
+
+    /**
+     * @brief Reset, refill the data buffer of the display
+     * @param value Null-terminated characters in program memory, e.g. `F("PLAY")`
+     */
+    void reset(const __FlashStringHelper *value) {
+        auto text = reinterpret_cast<const char *>(value);
+        rewind();
+        for (char c; (c = static_cast<char>(pgm_read_byte(text))); ++text)
+            append(c);
+        finish();
+    }
+
+    /**
+     * @brief Start rewriting the data buffer from its first digit
+     * @details The buffer is rewritten in place through `put()` and `append()`. `finish()` drops what is left of the
+     * previous content and tells whether the buffer changed, so unchanged content costs no copy and no allocation
+     */
+    inline void rewind() noexcept {
+        cursor_ = 0;
+        changed_ = false;
+    }
+
+    /**
+     * @brief Write an already encoded digit at the current position of the data buffer
+     * @param digit Encoded digit
+     */
+    void put(uint8_t digit) {
+        if (cursor_ < buffer_.length()) {
+            changed_ |= buffer_[cursor_] != digit;
+            buffer_[cursor_++] = digit;
+        } else if (buffer_.push(digit)) {
+            ++cursor_;
+            changed_ = true;
         }
     }
 
+    /**
+     * @brief Encode a character and write it at the current position of the data buffer. A '.' lights the dot of
+     * the previous digit
+     * @param c Character to append
+     */
+    void append(char c) {
+        auto d = toDisplayDigit(c);
+        if (d == 0x80u && cursor_ > 0) {
+            changed_ |= !(buffer_[cursor_ - 1] & 0x80u);
+            buffer_[cursor_ - 1] |= 0x80u;
+        } else
+            put(d);
+    }
+
+    /**
+     * @brief End the rewrite started with `rewind()`
+     * @return true if the content of the data buffer changed
+     */
+    bool finish() {
+        if (cursor_ < buffer_.length()) {
+            buffer_.truncate(cursor_);
+            changed_ = true;
+        }
+        return changed_;
+    }
+
     /**
      * @brief Cancel all animation. Set the display to the normal state.
      */
     inline void resetAnimation() noexcept {
-        currentAnimation = Animation::NONE;
+        for (auto &track : tracks_)
+            track.running = false;
+        blanked_ = false;
     }
 
     /**
@@ -208,12 +432,7 @@ public:
      * to the screen
      */
     void clear() {
-        buffer_ = "";
-        for (size_t counter{}; counter < totalDigits_; ++counter)
-            buffer_.concat(static_cast<char>(0x00u));
-        dp_ = 0;
-        colon_ = 0;
-        resetAnimation();
+        blank();
         refresh();
     }
 
@@ -221,15 +440,252 @@ public:
      * @brief Transfer the display's data buffer to the display device
      */
     void refresh() {
-        sendToDisplay<DataCommand_e::AUTOMATIC_ADDRESS_ADDING, AddressCommand_e::C0H>(
-                brightness_,
-                reinterpret_cast<const uint8_t *>(buffer_.c_str()),
-                static_cast<size_t>(min((unsigned int) totalDigits_, buffer_.length())));
+        const Track &track = tracks_[SCROLL_TRACK];
+        if (streaming()) {
+            transmit(window_, totalDigits_);
+            return;
+        }
+        if (!track.running || (!track.position && track.mode != static_cast<uint8_t>(ScrollMode_e::MARQUEE))) {
+            transmit(buffer_.data(), min(static_cast<size_t>(totalDigits_), buffer_.length()));
+            return;
+        }
+        uint8_t window[MAX_DIGITS];
+        for (uint8_t counter{}; counter < totalDigits_ && counter < MAX_DIGITS; ++counter)
+            window[counter] = scrolled(counter);
+        transmit(window, totalDigits_);
+    }
+
+    /**
+     * @brief Forget what the display device holds, so the next refresh resends every digit and command. Call it if
+     * the device lost its content, e.g. after a power glitch
+     */
+    inline void invalidate() noexcept {
+        shadowed_ = 0;
+        forgetCommands();
     }
 
 private:
-    inline uint8_t toDisplayDigit(signed char c) noexcept {
-        return c < 0 ? 0x00 : ascii[static_cast<unsigned>(c)];
+    static inline uint8_t toDisplayDigit(char c) noexcept {
+        return tm1637_lib::detail::glyph(c);
+    }
+
+    /**
+     * @brief Blank the buffer, the dots and the colon and stop the animations, without sending anything
+     */
+    void blank() {
+        rewind();
+        for (size_t counter{}; counter < totalDigits_; ++counter)
+            put(0x00u);
+        finish();
+        dp_ = 0;
+        colon_ = 0;
+        resetAnimation();
+    }
+
+    /**
+     * @brief Step every due animation without sending anything
+     * @return What has to be sent to the display, Change_e flags
+     */
+    uint8_t advance(duration_type now) {
+        uint8_t changes = NO_CHANGE;
+        for (uint8_t track = 0; track < TOTAL_TRACKS; ++track) {
+            if (tracks_[track].running && tracks_[track].tasker.check(now))
+                changes |= step(static_cast<Track_e>(track));
+        }
+        return changes;
+    }
+
+    /**
+     * @brief Send what the animations changed: the frame if the digits changed, only the display control otherwise
+     * @param changes Change_e flags returned by `advance()`
+     */
+    void sendChanges(uint8_t changes) {
+        if (changes & CONTENT_CHANGE)
+            refresh();
+        else if (changes & CONTROL_CHANGE)
+            refreshControl();
+    }
+
+    /**
+     * @brief Hand the changes of `tick()` to `sink` instead of sending them
+     */
+    inline void route(sink_type sink, void *context) noexcept {
+        sink_ = sink;
+        sinkContext_ = context;
+    }
+
+    void start(Track_e track, duration_type delay, uint8_t mode) {
+        tracks_[track].tasker.reset(delay, static_cast<duration_type>(millis()));
+        tracks_[track].position = 0;
+        tracks_[track].mode = mode;
+        tracks_[track].running = true;
+    }
+
+    inline bool streaming() const noexcept {
+        return tracks_[SCROLL_TRACK].running && tracks_[SCROLL_TRACK].mode == STREAM_MODE;
+    }
+
+    void stream(source_type source, void *context, duration_type delay, bool endless) {
+        if (!streaming() || source_ != source || context_ != context) {
+            source_ = source;
+            context_ = context;
+            endless_ = endless;
+            next_ = NO_CHARACTER;
+            for (auto &digit : window_)
+                digit = 0x00;
+            start(SCROLL_TRACK, delay, STREAM_MODE);
+        }
+        tick();
+    }
+
+    static int readStream(void *context) {
+        auto &source = *static_cast<Stream *>(context);
+        return source.available() > 0 ? source.read() : -1;
+    }
+
+    static int readFlash(void *context) {
+        auto &self = *static_cast<BasicAnimator *>(context);
+        auto c = static_cast<char>(pgm_read_byte(self.flashCursor_));
+        if (!c)
+            return -1;
+        ++self.flashCursor_;
+        return static_cast<unsigned char>(c);
+    }
+
+    /**
+     * @brief Pull the next digit from the stream source. A '.' following a character lights the dot of its digit
+     * @return false at the end of the source
+     */
+    bool pull(uint8_t &digit) {
+        int c = next_ != NO_CHARACTER ? next_ : source_(context_);
+        next_ = NO_CHARACTER;
+        if (c < 0) {
+            digit = 0x00;
+            return false;
+        }
+        digit = toDisplayDigit(static_cast<char>(c));
+        if (digit == 0x80u)
+            return true;
+        while ((next_ = source_(context_)) == '.') {
+            digit |= 0x80u;
+            next_ = NO_CHARACTER;
+        }
+        // Nothing to look ahead yet: ask the source again on the next pull
+        if (next_ < 0)
+            next_ = NO_CHARACTER;
+        return true;
+    }
+
+    bool stepStream(Track &track) {
+        uint8_t digit;
+        if (pull(digit))
+            track.position = 0;
+        else if (!endless_ && ++track.position > totalDigits_) {
+            track.running = false;
+            return false;
+        }
+        for (uint8_t counter = 1; counter < totalDigits_ && counter < MAX_DIGITS; ++counter)
+            window_[counter - 1] = window_[counter];
+        window_[min(totalDigits_, MAX_DIGITS) - 1] = digit;
+        return true;
+    }
+
+    void fade(Fade_e direction, duration_type delay) {
+        if (!tracks_[FADE_TRACK].running || tracks_[FADE_TRACK].mode != direction)
+            start(FADE_TRACK, delay, direction);
+        tick();
+    }
+
+    /**
+     * @brief Digit shown at a position of the display by the running scroll
+     */
+    uint8_t scrolled(uint8_t digit) const noexcept {
+        const Track &track = tracks_[SCROLL_TRACK];
+        size_t index = digit;
+        switch (static_cast<ScrollMode_e>(track.mode & ~BOUNCE_BACK)) {
+            case ScrollMode_e::RIGHT:
+                if (digit < track.position)
+                    return 0x00;
+                index -= track.position;
+                break;
+            case ScrollMode_e::MARQUEE:
+                index = (index + track.position) % (buffer_.length() + totalDigits_);
+                break;
+            default:
+                index += track.position;
+                break;
+        }
+        return index < buffer_.length() ? buffer_[index] : 0x00;
+    }
+
+    /**
+     * @brief Advance an animation by one step
+     * @return What has to be sent to the display, see Change_e
+     */
+    Change_e step(Track_e track) {
+        Track &current = tracks_[track];
+        switch (track) {
+            case BLINK_TRACK:
+                blanked_ = !blanked_;
+                return CONTROL_CHANGE;
+            case FADE_TRACK: {
+                auto level = control2Int(brightness_);
+                if (current.mode == FADE_OUT ? level == 0 : brightness_ == DisplayControl_e::PULSE_WIDTH_14_16) {
+                    current.running = false;
+                    return NO_CHANGE;
+                }
+                brightness_ = fetchControl(current.mode == FADE_OUT ? level - 1 : level + 1);
+                return CONTROL_CHANGE;
+            }
+            case SCROLL_TRACK:
+                return stepScroll(current) ? CONTENT_CHANGE : NO_CHANGE;
+            default:
+                return NO_CHANGE;
+        }
+    }
+
+    bool stepScroll(Track &track) {
+        if (track.mode == STREAM_MODE)
+            return stepStream(track);
+        const size_t length = buffer_.length();
+        switch (static_cast<ScrollMode_e>(track.mode & ~BOUNCE_BACK)) {
+            case ScrollMode_e::LEFT:
+            case ScrollMode_e::RIGHT:
+                if (track.position >= (track.mode == static_cast<uint8_t>(ScrollMode_e::LEFT) ? length : totalDigits_)) {
+                    track.running = false;
+                    return false;
+                }
+                ++track.position;
+                return true;
+            case ScrollMode_e::MARQUEE:
+                track.position = static_cast<uint16_t>((track.position + 1u) % (length + totalDigits_));
+                return true;
+            case ScrollMode_e::BOUNCE: {
+                const size_t end = length > totalDigits_ ? length - totalDigits_ : 0;
+                if (!end)
+                    return false;
+                if (track.position >= end)
+                    track.mode |= BOUNCE_BACK;
+                else if (!track.position)
+                    track.mode &= static_cast<uint8_t>(~BOUNCE_BACK);
+                if (track.mode & BOUNCE_BACK)
+                    --track.position;
+                else
+                    ++track.position;
+                return true;
+            }
+            default:
+                return false;
+        }
+    }
+
+    duration_type nextDeadline(duration_type now) const {
+        duration_type deadline = NO_DEADLINE;
+        for (const auto &track : tracks_) {
+            if (track.running)
+                deadline = min(deadline, track.tasker.remaining(now));
+        }
+        return deadline;
     }
 
     static inline uint8_t control2Int(DisplayControl_e e) noexcept {
@@ -279,58 +735,235 @@ private:
         return DisplayControl_e::PULSE_WIDTH_14_16;
     }
 
-    template<DataCommand_e DATA_COMMAND, AddressCommand_e ADDRESS_COMMAND>
+    /**
+     * @brief Send the display control alone, in a single one byte transaction. The digits are left untouched
+     */
     void sendToDisplay(DisplayControl_e displayControl) const noexcept {
-        mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(DATA_COMMAND));
-        mi2C_.endTransmission();
-        mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(ADDRESS_COMMAND));
-        mi2C_.endTransmission();
-        mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(displayControl));
-        mi2C_.endTransmission();
+        auto begin = startFrame();
+        uint8_t attempt = 0;
+        while (sendControl(displayControl) && retry(attempt));
+        endFrame(begin);
     }
 
-    template<DataCommand_e DATA_COMMAND, AddressCommand_e ADDRESS_COMMAND>
-    void sendToDisplay(DisplayControl_e displayControl, const uint8_t *values, size_t size) const noexcept {
-        mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(DATA_COMMAND));
+    /**
+     * @brief Send a data command, unless it is the one the device last received
+     * @return true if the device did not acknowledge
+     */
+    bool sendDataCommand(DataCommand_e command) const noexcept {
+        if (dataShadow_ == static_cast<uint8_t>(command))
+            return false;
+        dataShadow_ = static_cast<uint8_t>(command);
+        return sendCommand(dataShadow_);
+    }
+
+    /**
+     * @brief Send a display control, unless it is the one the device last received
+     * @return true if the device did not acknowledge
+     */
+    bool sendControl(DisplayControl_e control) const noexcept {
+        if (controlShadow_ == static_cast<uint8_t>(control))
+            return false;
+        controlShadow_ = static_cast<uint8_t>(control);
+        return sendCommand(controlShadow_);
+    }
+
+    /**
+     * @brief Make the next data command and display control be sent, whatever they are
+     */
+    inline void forgetCommands() const noexcept {
+        dataShadow_ = 0;
+        controlShadow_ = 0;
+    }
+
+    /**
+     * @brief Recover the bus after a frame that was not acknowledged
+     * @param attempt Retries done so far for the frame, incremented
+     * @return true if the frame should be sent again, false if it is given up
+     */
+    bool retry(uint8_t &attempt) const noexcept {
+        mi2C_.recover();
+        forgetCommands();
+        if (attempt++ == TM1637_RETRIES) {
+            ++failures_;
+            return false;
+        }
+#if TM1637_STATS
+        ++stats_.retries;
+#endif
+        return true;
+    }
+
+    /**
+     * @return true if the device did not acknowledge
+     */
+    bool sendCommand(uint8_t command) const noexcept {
+        beginTransmission();
+        bool NAK = send(command);
         mi2C_.endTransmission();
-        mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(ADDRESS_COMMAND));
+        return NAK;
+    }
+
+    /**
+     * @return true if the device did not acknowledge one of the bytes
+     */
+    bool sendData(uint8_t address, const uint8_t *values, size_t size) const noexcept {
+        beginTransmission();
+        bool NAK = send(static_cast<uint8_t>(static_cast<uint8_t>(AddressCommand_e::C0H) + address));
         for (decltype(size) counter{}; counter < size; ++counter)
-            mi2C_.send((colon_ || (dp_ & (1u << counter))) ? values[counter] | 0x80u : values[counter]);
+            NAK |= send(values[counter]);
         mi2C_.endTransmission();
+        return NAK;
+    }
+
+    void beginTransmission() const noexcept {
         mi2C_.beginTransmission();
-        mi2C_.send(static_cast<uint8_t>(displayControl));
-        mi2C_.endTransmission();
+#if TM1637_STATS
+        ++stats_.transactions;
+#endif
+    }
+
+    bool send(uint8_t value) const noexcept {
+        bool NAK = mi2C_.send(value) != 0;
+#if TM1637_STATS
+        ++stats_.bytes;
+        stats_.naks += NAK;
+#endif
+        return NAK;
     }
 
-    String buffer_ = "";
-    MI2C mi2C_;
+    inline unsigned long startFrame() const noexcept {
+#if TM1637_STATS
+        frameTransactions_ = stats_.transactions;
+        return micros();
+#else
+        return 0;
+#endif
+    }
+
+    inline void endFrame(unsigned long begin) const noexcept {
+#if TM1637_STATS
+        if (stats_.transactions == frameTransactions_) {
+            ++stats_.skippedFrames;
+            return;
+        }
+        auto elapsed = static_cast<uint32_t>(micros() - begin);
+        ++stats_.frames;
+        stats_.busMicros += elapsed;
+        if (elapsed > stats_.maxFrameMicros)
+            stats_.maxFrameMicros = elapsed;
+#else
+        (void) begin;
+#endif
+    }
+
+    // Approximate bus cost in clock periods: 9 per byte, about one per start/stop pair
+    static constexpr unsigned burstCost(size_t span) noexcept { return 3 + 9 * (span + 3); }
+
+    static constexpr unsigned fixedCost(size_t dirty) noexcept { return dirty + 2 + 9 * (2 * dirty + 2); }
+
+    /**
+     * @brief Send a frame, again up to TM1637_RETRIES times if the device does not acknowledge it
+     * @details What the device holds is unknown after a NAK, so every retry resends all the digits. A frame given up
+     * leaves the shadow empty: the next refresh resends all the digits as well
+     */
+    void transmit(const uint8_t *values, size_t size) noexcept {
+        auto begin = startFrame();
+        for (uint8_t attempt = 0; sendFrame(values, size);) {
+            shadowed_ = 0;
+            if (!retry(attempt))
+                break;
+        }
+        endFrame(begin);
+    }
+
+    /**
+     * @brief Send the digits that differ from what the device holds, followed by the display control
+     * @details Few changed digits are written one by one with `FIXED_ADDRESS`, otherwise the span from the first to
+     * the last changed digit is sent as one `AUTOMATIC_ADDRESS_ADDING` burst
+     * @return true if the device did not acknowledge
+     */
+    bool sendFrame(const uint8_t *values, size_t size) noexcept {
+        bool NAK = false;
+        uint8_t frame[MAX_DIGITS];
+        uint8_t dirty = 0;
+        size_t first = MAX_DIGITS, last = 0, total = 0;
+        if (size > MAX_DIGITS)
+            size = MAX_DIGITS;
+        for (decltype(size) counter{}; counter < size; ++counter) {
+            frame[counter] = (colon_ || (dp_ & (1u << counter))) ? values[counter] | 0x80u : values[counter];
+            if ((shadowed_ & (1u << counter)) && shadow_[counter] == frame[counter])
+                continue;
+            dirty |= static_cast<uint8_t>(1u << counter);
+            if (first == MAX_DIGITS)
+                first = counter;
+            last = counter;
+            ++total;
+        }
+        if (total && fixedCost(total) < burstCost(last - first + 1)) {
+            NAK |= sendDataCommand(DataCommand_e::FIXED_ADDRESS);
+            for (auto counter = first; counter <= last; ++counter) {
+                if (dirty & (1u << counter))
+                    NAK |= sendData(static_cast<uint8_t>(counter), frame + counter, 1);
+            }
+        } else if (total) {
+            NAK |= sendDataCommand(DataCommand_e::AUTOMATIC_ADDRESS_ADDING);
+            NAK |= sendData(static_cast<uint8_t>(first), frame + first, last - first + 1);
+        }
+        NAK |= sendControl(blanked_ ? DisplayControl_e::DISPLAY_OFF : brightness_);
+        for (decltype(size) counter{}; counter < size; ++counter)
+            shadow_[counter] = frame[counter];
+        shadowed_ |= dirty;
+        return NAK;
+    }
+
+    static constexpr uint8_t MAX_DIGITS = 6;
+
+    Framebuffer buffer_;
+    size_t cursor_{};
+    bool changed_{};
+    Bus mi2C_;
     DisplayControl_e brightness_ = DisplayControl_e::DISPLAY_ON;
-    uint8_t dp_;
-    uint8_t colon_;
+    uint8_t dp_{};
+    uint8_t colon_{};
     const uint8_t totalDigits_;
-    Tasker tasker;
-    Animation currentAnimation = Animation::NONE;
-    const uint8_t ascii[128] =
-            {
-                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
-                    0x00, 0x00, 0x00, 0x00, 0x22, 0x00, 0x6D, 0x00, 0x00, 0x20,
-                    0x39, 0x0F, 0x00, 0x00, 0x10, 0x40, 0x80, 0x52, 0x3F, 0x06,
-                    0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x00, 0x00,
-                    0x00, 0x48, 0x00, 0x53, 0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79,
-                    0x71, 0x3D, 0x76, 0x30, 0x1E, 0x00, 0x38, 0x00, 0x54, 0x3F,
-                    0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x00, 0x00, 0x00, 0x6E,
-                    0x5B, 0x39, 0x64, 0x00, 0x0F, 0x08, 0x20, 0x77, 0x7C, 0x58,
-                    0x5E, 0x79, 0x71, 0x3D, 0x74, 0x04, 0x1E, 0x00, 0x38, 0x00,
-                    0x54, 0x5C, 0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x00, 0x00,
-                    0x00, 0x6E, 0x5B, 0x39, 0x30, 0x0F, 0x40, 0x00,
-            };
+    uint8_t shadow_[MAX_DIGITS]{};
+    uint8_t shadowed_{};
+    // Last data command and display control sent, 0 if unknown
+    mutable uint8_t dataShadow_{};
+    mutable uint8_t controlShadow_{};
+    Track tracks_[TOTAL_TRACKS]{};
+    bool blanked_{};
+    source_type source_{};
+    void *context_{};
+    sink_type sink_{};
+    void *sinkContext_{};
+    const __FlashStringHelper *flashText_{};
+    const char *flashCursor_{};
+    int next_ = NO_CHARACTER;
+    bool endless_{};
+    uint8_t window_[MAX_DIGITS]{};
+    mutable uint16_t failures_{};
+#if TM1637_STATS
+    mutable tm1637_lib::Statistics stats_{};
+    mutable uint32_t frameTransactions_{};
+#endif
 };
 
+template<class Bus>
+constexpr uint8_t BasicAnimator<Bus>::MAX_DIGITS;
+
+template<class Bus>
+constexpr uint8_t BasicAnimator<Bus>::BOUNCE_BACK;
+
+template<class Bus>
+constexpr uint8_t BasicAnimator<Bus>::STREAM_MODE;
+
+template<class Bus>
+constexpr int BasicAnimator<Bus>::NO_CHARACTER;
+
+template<class Bus>
+constexpr typename BasicAnimator<Bus>::duration_type BasicAnimator<Bus>::NO_DEADLINE;
+
+using Animator = BasicAnimator<MI2C>;
+
 #endif //TM1637_ANIMATOR_H
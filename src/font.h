@@ -0,0 +1,79 @@
+#ifndef TM1637_FONT_H
+#define TM1637_FONT_H
+
+#include <Arduino.h>
+
+// Glyphs of the ASCII characters 0 to 127. Expanded into the flash table and into the compile-time table below
+#define TM1637_ASCII_GLYPHS \
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+        0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+        0x00, 0x00, 0x00, 0x00, 0x22, 0x00, 0x6D, 0x00, 0x00, 0x20, \
+        0x39, 0x0F, 0x00, 0x00, 0x10, 0x40, 0x80, 0x52, 0x3F, 0x06, \
+        0x5B, 0x4F, 0x66, 0x6D, 0x7D, 0x07, 0x7F, 0x6F, 0x00, 0x00, \
+        0x00, 0x48, 0x00, 0x53, 0x00, 0x77, 0x7C, 0x39, 0x5E, 0x79, \
+        0x71, 0x3D, 0x76, 0x30, 0x1E, 0x00, 0x38, 0x00, 0x54, 0x3F, \
+        0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x00, 0x00, 0x00, 0x6E, \
+        0x5B, 0x39, 0x64, 0x00, 0x0F, 0x08, 0x20, 0x77, 0x7C, 0x58, \
+        0x5E, 0x79, 0x71, 0x3D, 0x74, 0x04, 0x1E, 0x00, 0x38, 0x00, \
+        0x54, 0x5C, 0x73, 0x67, 0x50, 0x6D, 0x78, 0x3E, 0x00, 0x00, \
+        0x00, 0x6E, 0x5B, 0x39, 0x30, 0x0F, 0x40, 0x00
+
+namespace tm1637_lib
+{
+namespace detail
+{
+    /**
+     * @brief Seven-segment glyph of each ASCII character, stored once in program memory and shared by every display
+     * @details A class template, so the table is defined in the header without being duplicated across translation
+     * units. Read it through `glyph()`
+     */
+    template <class = void>
+    struct Font
+    {
+        static const uint8_t ascii[128];
+    };
+
+    template <class T>
+    const uint8_t Font<T>::ascii[128] PROGMEM = {TM1637_ASCII_GLYPHS};
+
+    /**
+     * @brief Same glyphs as Font, usable in constant expressions. Only read during constant evaluation, see
+     * `constexprGlyph()`: it never takes any RAM
+     */
+    template <class = void>
+    struct ConstexprFont
+    {
+        static constexpr uint8_t ascii[128] = {TM1637_ASCII_GLYPHS};
+    };
+
+    template <class T>
+    constexpr uint8_t ConstexprFont<T>::ascii[128];
+
+    /**
+     * @brief Encode a character into its seven-segment glyph
+     * @return Segments to light, 0x00 for characters without glyph
+     */
+    inline uint8_t glyph(char c) noexcept
+    {
+        auto index = static_cast<unsigned char>(c);
+        return index < 128 ? pgm_read_byte(&Font<>::ascii[index]) : 0x00;
+    }
+
+    /**
+     * @brief Compile-time counterpart of `glyph()`
+     * @details Evaluated at compile time when `c` is a constant, e.g. when it initialises a constexpr variable. A
+     * character only known at runtime is read from the flash table through `glyph()` instead, so ConstexprFont never
+     * has to be stored: on AVR it would otherwise be copied to SRAM
+     */
+    constexpr uint8_t constexprGlyph(char c) noexcept
+    {
+        return !__builtin_constant_p(c) ? glyph(c) :
+               static_cast<unsigned char>(c) < 128 ? ConstexprFont<>::ascii[static_cast<unsigned char>(c)] : 0x00;
+    }
+}
+}
+
+#undef TM1637_ASCII_GLYPHS
+
+#endif //TM1637_FONT_H
@@ -0,0 +1,111 @@
+#ifndef TM1637_FORMATTER_H
+#define TM1637_FORMATTER_H
+
+#include <Arduino.h>
+#include "type_traits.h"
+
+namespace tm1637_lib
+{
+namespace detail
+{
+    template <typename T>
+    inline typename type_traits::enable_if<type_traits::is_signed<T>::value, bool>::type isNegative(T value) noexcept
+    {
+        return value < 0;
+    }
+
+    template <typename T>
+    inline typename type_traits::enable_if<!type_traits::is_signed<T>::value, bool>::type isNegative(T) noexcept
+    {
+        return false;
+    }
+
+    /**
+     * @brief Emit the decimal digits of a fixed-point value, most significant first
+     * @param sink Receives the characters through `append(char)`
+     * @param mantissa Value scaled by 10^decimals
+     * @param decimals Number of digits after the decimal point. The point is only emitted if non-zero
+     */
+    template <class Sink>
+    void formatFixed(Sink &sink, unsigned long mantissa, uint8_t decimals = 0)
+    {
+        char digits[20];
+        uint8_t count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + mantissa % 10);
+            mantissa /= 10;
+        } while ((mantissa || count <= decimals) && count < sizeof(digits));
+        while (count) {
+            sink.append(digits[--count]);
+            if (count && count == decimals)
+                sink.append('.');
+        }
+    }
+
+    /**
+     * @brief Emit an integral value like `String(value)` would format it, without building the string
+     * @param decimals Treat the value as a fixed-point mantissa with that many digits after the decimal point
+     */
+    template <class Sink, typename T>
+    void formatInteger(Sink &sink, T value, uint8_t decimals = 0)
+    {
+        if (isNegative(value)) {
+            sink.append('-');
+            formatFixed(sink, 0ul - static_cast<unsigned long>(value), decimals);
+        } else
+            formatFixed(sink, static_cast<unsigned long>(value), decimals);
+    }
+
+    /**
+     * @brief Emit a floating point value like `String(value, decimals)` would format it, without building the string
+     * @details The value is rounded to a fixed-point mantissa whenever it fits an unsigned long, otherwise the digits
+     * are produced like `Print::printFloat()` does. NaN is shown as "nan", values out of the unsigned long range as
+     * "ovf"
+     */
+    template <class Sink, typename T>
+    void formatFloat(Sink &sink, T value, uint8_t decimals)
+    {
+        static constexpr T LIMIT = static_cast<T>(4294967040.0);
+        if (value != value) {
+            sink.append('n');
+            sink.append('a');
+            sink.append('n');
+            return;
+        }
+        if (value < 0) {
+            sink.append('-');
+            value = -value;
+        }
+        if (value > LIMIT) {
+            sink.append('o');
+            sink.append('v');
+            sink.append('f');
+            return;
+        }
+        T scaled = value;
+        for (uint8_t counter{}; counter < decimals && scaled <= LIMIT; ++counter)
+            scaled *= 10;
+        if (scaled + static_cast<T>(0.5) <= LIMIT) {
+            formatFixed(sink, static_cast<unsigned long>(scaled + static_cast<T>(0.5)), decimals);
+            return;
+        }
+        T rounding = 0.5;
+        for (uint8_t counter{}; counter < decimals; ++counter)
+            rounding /= 10;
+        value += rounding;
+        auto integer = static_cast<unsigned long>(value);
+        T remainder = value - static_cast<T>(integer);
+        formatFixed(sink, integer);
+        if (decimals)
+            sink.append('.');
+        while (decimals--) {
+            remainder *= 10;
+            auto digit = static_cast<uint8_t>(remainder);
+            remainder -= digit;
+            sink.append(static_cast<char>('0' + digit));
+        }
+    }
+}
+}
+
+#endif //TM1637_FORMATTER_H
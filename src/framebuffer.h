@@ -0,0 +1,101 @@
+#ifndef TM1637_FRAMEBUFFER_H
+#define TM1637_FRAMEBUFFER_H
+
+#include <Arduino.h>
+
+// Keep the display content in fixed-size arrays instead of Arduino Strings, so the display path never touches the heap
+#ifndef TM1637_STATIC_BUFFER
+#define TM1637_STATIC_BUFFER 0
+#endif
+
+// Number of encoded digits the static framebuffer holds: four screens of scrolling text by default. Longer content is
+// cut off
+#ifndef TM1637_BUFFER_SIZE
+#define TM1637_BUFFER_SIZE 16
+#endif
+
+/**
+ * @brief Framebuffer of encoded digits stored in a fixed-size array. Never allocates
+ * @tparam CAPACITY Maximum number of digits the buffer holds
+ */
+template<size_t CAPACITY>
+class StaticFramebuffer {
+    static_assert(CAPACITY > 0 && CAPACITY < 256, "Framebuffer capacity must be between 1 and 255 digits");
+
+public:
+    inline size_t length() const noexcept { return length_; }
+
+    inline const uint8_t *data() const noexcept { return data_; }
+
+    inline uint8_t &operator[](size_t index) noexcept { return data_[index]; }
+
+    inline uint8_t operator[](size_t index) const noexcept { return data_[index]; }
+
+    inline void clear() noexcept { length_ = 0; }
+
+    /**
+     * @brief Append an encoded digit
+     * @return false if the buffer is full and the digit was dropped
+     */
+    inline bool push(uint8_t value) noexcept {
+        if (length_ >= CAPACITY)
+            return false;
+        data_[length_++] = value;
+        return true;
+    }
+
+    inline void truncate(size_t size) noexcept {
+        if (size < length_)
+            length_ = static_cast<uint8_t>(size);
+    }
+
+    bool operator==(const StaticFramebuffer &rhs) const noexcept {
+        if (length_ != rhs.length_)
+            return false;
+        for (uint8_t counter{}; counter < length_; ++counter) {
+            if (data_[counter] != rhs.data_[counter])
+                return false;
+        }
+        return true;
+    }
+
+private:
+    uint8_t data_[CAPACITY]{};
+    uint8_t length_{};
+};
+
+/**
+ * @brief Framebuffer of encoded digits stored in an Arduino String. Grows as needed
+ */
+class StringFramebuffer {
+public:
+    inline size_t length() const noexcept { return buffer_.length(); }
+
+    inline const uint8_t *data() const noexcept { return reinterpret_cast<const uint8_t *>(buffer_.c_str()); }
+
+    inline uint8_t &operator[](size_t index) noexcept { return reinterpret_cast<uint8_t &>(buffer_[index]); }
+
+    inline uint8_t operator[](size_t index) const noexcept { return static_cast<uint8_t>(buffer_[index]); }
+
+    inline void clear() noexcept { buffer_ = ""; }
+
+    inline bool push(uint8_t value) noexcept { return buffer_.concat(static_cast<char>(value)); }
+
+    inline void truncate(size_t size) noexcept {
+        if (size < buffer_.length())
+            buffer_.remove(size);
+    }
+
+    bool operator==(const StringFramebuffer &rhs) const noexcept { return buffer_ == rhs.buffer_; }
+
+private:
+    String buffer_ = "";
+};
+
+#if TM1637_STATIC_BUFFER
+using Framebuffer = StaticFramebuffer<TM1637_BUFFER_SIZE>;
+#else
+using Framebuffer = StringFramebuffer;
+#endif
+
+#endif //TM1637_FRAMEBUFFER_H
@@ -3,72 +3,834 @@
 
 #include <Arduino.h>
 
-// Put a longer delay in case your TM1637 is having issues with timing due to onboard capacitors
+// Put a longer delay in case your TM1637 is having issues with timing due to onboard capacitors. It is the starting
+// bit delay of each display, which BasicTM1637::setBitDelay() and BasicTM1637::calibrate() can lower per display
 #ifndef TM1637_DELAY
 #define TM1637_DELAY 2
 #endif
 
-class MI2C
+// Microseconds added back to the fastest bit delay that BasicMI2C::calibrate() finds the device still acknowledging
+#ifndef TM1637_CALIBRATION_MARGIN
+#define TM1637_CALIBRATION_MARGIN 1
+#endif
+
+// Probe commands that must all be acknowledged for BasicMI2C::calibrate() to accept a bit delay
+#ifndef TM1637_CALIBRATION_PROBES
+#define TM1637_CALIBRATION_PROBES 4
+#endif
+
+// Toggle the pins through their port registers instead of digitalWrite/pinMode. Enabled by default on AVR, can be
+// enabled on any other core that provides portOutputRegister/portModeRegister/portInputRegister
+#ifndef TM1637_PORT_IO
+#if defined(__AVR__)
+#define TM1637_PORT_IO 1
+#else
+#define TM1637_PORT_IO 0
+#endif
+#endif
+
+// Type the port registers point to. Spelled out rather than deduced: on AVR portOutputRegister() and
+// digitalPinToBitMask() read PROGMEM tables through GCC statement-expressions, which decltype only takes in a function
+#ifndef TM1637_PORT_REGISTER
+#define TM1637_PORT_REGISTER volatile uint8_t
+#endif
+
+// Boards whose pin-to-port mapping is known at compile time. StaticMI2C compiles down to single sbi/cbi instructions
+// on them. Only the ATmega168/328 I/O map is known: the ATmega8 has its port registers elsewhere
+#ifndef TM1637_STATIC_PIN_MAP
+#if defined(__AVR_ATmega328P__) || defined(__AVR_ATmega328__) || defined(__AVR_ATmega168__) || \
+    defined(__AVR_ATmega168P__)
+#define TM1637_STATIC_PIN_MAP 1
+#else
+#define TM1637_STATIC_PIN_MAP 0
+#endif
+#endif
+
+// Queue the transfers and clock them out one step per BasicMI2C::poll() call (e.g. from a timer interrupt) instead of
+// blocking the caller for the whole frame
+#ifndef TM1637_ASYNC
+#define TM1637_ASYNC 0
+#endif
+
+// Number of bytes the asynchronous transfer queue holds. A full display refresh takes at most 9
+#ifndef TM1637_ASYNC_QUEUE
+#define TM1637_ASYNC_QUEUE 32
+#endif
+
+namespace tm1637_lib
+{
+namespace detail
+{
+#if TM1637_ASYNC
+    /**
+     * @brief Keep the compiler from moving memory accesses across this point, e.g. the queue entries past the
+     * volatile index that hands them over to poll()
+     */
+    inline void barrier() noexcept
+    {
+        asm volatile("" ::: "memory");
+    }
+#endif
+
+#if TM1637_PORT_IO
+    using port_register_t = TM1637_PORT_REGISTER *;
+    using port_mask_t = uint8_t;
+
+    template <typename Register, typename Mask>
+    inline void writePort(Register reg, Mask mask, uint8_t value) noexcept
+    {
+#ifdef SREG
+        // Other pins of the port may be changed from an ISR: keep the read-modify-write atomic like digitalWrite does
+        uint8_t oldSREG = SREG;
+        cli();
+#endif
+        if (value)
+            *reg |= mask;
+        else
+            *reg &= static_cast<Mask>(~mask);
+#ifdef SREG
+        SREG = oldSREG;
+#endif
+    }
+#endif
+
+    /**
+     * @brief Pins given at runtime. With TM1637_PORT_IO the port registers are resolved once in begin()
+     * @details The bit delay starts at TM1637_DELAY and can be changed per instance
+     */
+    class RuntimePins
+    {
+    public:
+        constexpr RuntimePins(uint8_t clkPin, uint8_t dataPin) noexcept : clkPin_{clkPin}, dataPin_{dataPin}
+        {}
+
+    protected:
+        static constexpr bool TUNABLE_DELAY = true;
+
+        uint8_t bitDelay() const noexcept { return delay_; }
+
+        void bitDelay(uint8_t delay) noexcept { delay_ = delay; }
+
+        void begin() noexcept
+        {
+#if TM1637_PORT_IO
+            clkOut_ = portOutputRegister(digitalPinToPort(clkPin_));
+            clkMask_ = digitalPinToBitMask(clkPin_);
+            dataOut_ = portOutputRegister(digitalPinToPort(dataPin_));
+            dataMode_ = portModeRegister(digitalPinToPort(dataPin_));
+            dataIn_ = portInputRegister(digitalPinToPort(dataPin_));
+            dataMask_ = digitalPinToBitMask(dataPin_);
+#endif
+            pinMode(clkPin_, OUTPUT);
+            pinMode(dataPin_, OUTPUT);
+        }
+
+#if TM1637_PORT_IO
+        void clk(uint8_t value) const noexcept { writePort(clkOut_, clkMask_, value); }
+
+        void data(uint8_t value) const noexcept { writePort(dataOut_, dataMask_, value); }
+
+        void dataMode(uint8_t mode) const noexcept
+        {
+            // Mirror pinMode(): switching to INPUT also clears the output latch (no pull-up). The direction changes
+            // first, so the line is never driven LOW on the way
+            writePort(dataMode_, dataMask_, mode == OUTPUT);
+            if (mode != OUTPUT)
+                writePort(dataOut_, dataMask_, LOW);
+        }
+
+        uint8_t readData() const noexcept { return (*dataIn_ & dataMask_) ? HIGH : LOW; }
+#else
+        void clk(uint8_t value) const noexcept { digitalWrite(clkPin_, value); }
+
+        void data(uint8_t value) const noexcept { digitalWrite(dataPin_, value); }
+
+        void dataMode(uint8_t mode) const noexcept { pinMode(dataPin_, mode); }
+
+        uint8_t readData() const noexcept { return digitalRead(dataPin_); }
+#endif
+
+        void wait() const noexcept { delayMicroseconds(delay_); }
+
+    private:
+        const uint8_t clkPin_, dataPin_;
+        uint8_t delay_ = TM1637_DELAY;
+#if TM1637_PORT_IO
+        port_register_t clkOut_{}, dataOut_{}, dataMode_{}, dataIn_{};
+        port_mask_t clkMask_{}, dataMask_{};
+#endif
+    };
+
+    /**
+     * @brief Pins and bit delay given as template parameters. Holds no data at runtime
+     */
+    template <uint8_t CLK_PIN, uint8_t DATA_PIN, unsigned DELAY>
+    class StaticPins
+    {
+    protected:
+        static constexpr bool TUNABLE_DELAY = false;
+
+        static constexpr uint8_t bitDelay() noexcept { return DELAY; }
+
+        static void bitDelay(uint8_t) noexcept
+        {}
+
+        static void begin() noexcept
+        {
+            pinMode(CLK_PIN, OUTPUT);
+            pinMode(DATA_PIN, OUTPUT);
+        }
+
+        static void clk(uint8_t value) noexcept { write<CLK_PIN>(value); }
+
+        static void data(uint8_t value) noexcept { write<DATA_PIN>(value); }
+
+        static void dataMode(uint8_t mode) noexcept
+        {
+#if TM1637_STATIC_PIN_MAP
+            if (mode == OUTPUT)
+                _SFR_IO8(io<DATA_PIN>() + 1) |= mask<DATA_PIN>();
+            else
+                _SFR_IO8(io<DATA_PIN>() + 1) &= static_cast<uint8_t>(~mask<DATA_PIN>());
+            if (mode != OUTPUT)
+                write<DATA_PIN>(LOW);
+#elif TM1637_PORT_IO
+            writePort(portModeRegister(digitalPinToPort(DATA_PIN)), digitalPinToBitMask(DATA_PIN), mode == OUTPUT);
+            if (mode != OUTPUT)
+                write<DATA_PIN>(LOW);
+#else
+            pinMode(DATA_PIN, mode);
+#endif
+        }
+
+        static uint8_t readData() noexcept
+        {
+#if TM1637_STATIC_PIN_MAP
+            return (_SFR_IO8(io<DATA_PIN>()) & mask<DATA_PIN>()) ? HIGH : LOW;
+#elif TM1637_PORT_IO
+            return (*portInputRegister(digitalPinToPort(DATA_PIN)) & digitalPinToBitMask(DATA_PIN)) ? HIGH : LOW;
+#else
+            return digitalRead(DATA_PIN);
+#endif
+        }
+
+        static void wait() noexcept { delayMicroseconds(DELAY); }
+
+    private:
+#if TM1637_STATIC_PIN_MAP
+        static_assert(CLK_PIN < 20 && DATA_PIN < 20, "Pin not available on this board");
+
+        // Address of the PINx register in I/O space: DDRx and PORTx follow at +1 and +2
+        template <uint8_t PIN>
+        static constexpr uint8_t io() { return PIN < 8 ? 0x09 : PIN < 14 ? 0x03 : 0x06; }
+
+        template <uint8_t PIN>
+        static constexpr uint8_t mask() { return static_cast<uint8_t>(1u << (PIN < 8 ? PIN : PIN < 14 ? PIN - 8 : PIN - 14)); }
+#endif
+
+        template <uint8_t PIN>
+        static void write(uint8_t value) noexcept
+        {
+#if TM1637_STATIC_PIN_MAP
+            // Constant address and mask: single sbi/cbi, atomic by itself
+            if (value)
+                _SFR_IO8(io<PIN>() + 2) |= mask<PIN>();
+            else
+                _SFR_IO8(io<PIN>() + 2) &= static_cast<uint8_t>(~mask<PIN>());
+#elif TM1637_PORT_IO
+            writePort(portOutputRegister(digitalPinToPort(PIN)), digitalPinToBitMask(PIN), value);
+#else
+            digitalWrite(PIN, value);
+#endif
+        }
+    };
+}
+}
+
+/**
+ * @brief Bit-banged two-wire protocol of the TM1637
+ * @tparam Pins Pin access policy, see tm1637_lib::detail::RuntimePins and tm1637_lib::detail::StaticPins
+ */
+template <class Pins>
+class BasicMI2C : private Pins
 {
 public:
-    constexpr MI2C(uint8_t clkPin, uint8_t dataPin) noexcept : clkPin_{clkPin}, dataPin_{dataPin}
-    {}
+    using Pins::Pins;
+
+    BasicMI2C() = default;
 
-    ~MI2C() = default;
+    ~BasicMI2C() = default;
 
-    MI2C(const MI2C&) = delete;
+    BasicMI2C(const BasicMI2C&) = delete;
 
-    MI2C& operator=(const MI2C&) = delete;
+    BasicMI2C& operator=(const BasicMI2C&) = delete;
 
-    void begin() const noexcept
+    void begin() noexcept
     {
-        pinMode(clkPin_, OUTPUT);
-        pinMode(dataPin_, OUTPUT);
+        Pins::begin();
     }
 
+#if TM1637_ASYNC
     void beginTransmission() const noexcept
     {
-        digitalWrite(clkPin_, HIGH);
-        digitalWrite(dataPin_, HIGH);
-        delayMicroseconds(TM1637_DELAY);
-        digitalWrite(dataPin_, LOW);
+        pending_ = START;
     }
 
     void endTransmission() const noexcept
     {
-        digitalWrite(clkPin_, LOW);
-        digitalWrite(dataPin_, LOW);
-        digitalWrite(clkPin_, HIGH);
-        delayMicroseconds(TM1637_DELAY);
-        digitalWrite(dataPin_, HIGH);
+        if (staged_) {
+            stagedFlags_ |= STOP;
+            publish();
+        }
     }
 
+    /**
+     * @brief Queue a byte. The ACK is not known yet, so the byte is assumed acknowledged
+     * @return Always 0 (ACK)
+     */
     uint8_t send(uint8_t value) const noexcept
     {
-        uint8_t ACK;
+        if (staged_)
+            publish();
+        staged_ = true;
+        stagedValue_ = value;
+        stagedFlags_ = pending_;
+        pending_ = 0;
+        return 0;
+    }
+
+    /**
+     * @brief Clock out the next step of the queued transfers
+     * @details Call it periodically, from loop() or from a timer interrupt. The call period replaces TM1637_DELAY
+     * as the bit timing, a byte takes about 21 calls
+     * @return true while transfers are pending
+     */
+    bool poll() const noexcept
+    {
+        if (polling_ || head_ == tail_)
+            return head_ != tail_;
+        polling_ = true;
+        step();
+        polling_ = false;
+        return head_ != tail_;
+    }
+
+    /**
+     * @return true while queued transfers haven't been completely clocked out
+     */
+    bool busy() const noexcept
+    {
+        return head_ != tail_;
+    }
+
+    /**
+     * @brief Block until every queued transfer is clocked out
+     */
+    void flush() const noexcept
+    {
+        while (poll());
+    }
+#else
+    void beginTransmission() const noexcept
+    {
+        writeStart();
+    }
+
+    void endTransmission() const noexcept
+    {
+        writeStop();
+    }
+
+    uint8_t send(uint8_t value) const noexcept
+    {
+        return writeByte(value);
+    }
+#endif
+
+    /**
+     * @brief Run a complete read transaction: send the command, then clock in the byte the device answers with
+     * @details The transaction is always blocking. With TM1637_ASYNC the queued transfers are flushed first, so the
+     * read keeps its place between the frames
+     * @param command Read command, e.g. READ_KEY_SCAN_DATA
+     * @return Byte sent by the device
+     */
+    uint8_t read(uint8_t command) const noexcept
+    {
+#if TM1637_ASYNC
+        flush();
+#endif
+        writeStart();
+        writeByte(command);
+        uint8_t value = readByte();
+        writeStop();
+        return value;
+    }
+
+    /**
+     * @return Delay between the clock edges, in microseconds
+     */
+    uint8_t getBitDelay() const noexcept
+    {
+        return this->bitDelay();
+    }
+
+    /**
+     * @brief Change the delay between the clock edges. No effect on StaticMI2C, whose delay is a template parameter
+     * @param delay Delay in microseconds
+     */
+    void setBitDelay(uint8_t delay) noexcept
+    {
+        this->bitDelay(delay);
+    }
+
+    /**
+     * @brief Lower the bit delay as far as the device keeps acknowledging, then add TM1637_CALIBRATION_MARGIN back
+     * @details The delay is stepped down from its current value, TM1637_CALIBRATION_PROBES data commands at a time,
+     * until one of them is not acknowledged. It never ends above its current value. StaticMI2C keeps its delay, and
+     * so does TM1637_ASYNC, where the poll() period times the frames instead
+     * @return Delay kept, in microseconds
+     */
+    uint8_t calibrate() noexcept
+    {
+        const uint8_t start = getBitDelay();
+        if (!Pins::TUNABLE_DELAY || TM1637_ASYNC)
+            return start;
+        uint8_t reliable = start;
+        while (reliable) {
+            setBitDelay(static_cast<uint8_t>(reliable - 1));
+            if (!probe())
+                break;
+            --reliable;
+        }
+        const uint8_t kept = static_cast<uint8_t>(
+                min(static_cast<unsigned>(start), static_cast<unsigned>(reliable) + TM1637_CALIBRATION_MARGIN));
+        setBitDelay(kept);
+        return kept;
+    }
+
+    /**
+     * @brief Bring the bus back to idle after a transfer the device did not acknowledge
+     * @details Nine clocks with DIO released (an input, left to the pull-up) complete any byte and ACK the device may
+     * still be waiting for, without fighting it if it holds DIO low. DIO is driven again once CLK is low, then a stop
+     * condition ends the transaction. With TM1637_ASYNC the queued transfers are flushed first
+     */
+    void recover() const noexcept
+    {
+#if TM1637_ASYNC
+        flush();
+#endif
+        this->dataMode(INPUT);
+        for (uint8_t i = 0; i < 9; ++i)
+        {
+            this->clk(LOW);
+            this->wait();
+            this->clk(HIGH);
+            this->wait();
+        }
+        this->clk(LOW);
+        this->dataMode(OUTPUT);
+        writeStop();
+    }
+
+private:
+    /**
+     * @return true if the device acknowledged every probe at the current bit delay
+     */
+    bool probe() const noexcept
+    {
+        for (uint8_t i = 0; i < TM1637_CALIBRATION_PROBES; ++i)
+        {
+            writeStart();
+            uint8_t NAK = writeByte(0x40);
+            writeStop();
+            if (NAK) {
+                recover();
+                return false;
+            }
+        }
+        return true;
+    }
+
+    void writeStart() const noexcept
+    {
+        this->clk(HIGH);
+        this->data(HIGH);
+        this->wait();
+        this->data(LOW);
+    }
+
+    void writeStop() const noexcept
+    {
+        this->clk(LOW);
+        this->data(LOW);
+        this->clk(HIGH);
+        this->wait();
+        this->data(HIGH);
+    }
+
+    uint8_t writeByte(uint8_t value) const noexcept
+    {
         for (uint8_t i = 0; i < 8; ++i)
         {
-            digitalWrite(clkPin_, LOW);
-            digitalWrite(dataPin_, value & 0x01);
-            delayMicroseconds(TM1637_DELAY);
-            digitalWrite(clkPin_, HIGH);
-            delayMicroseconds(TM1637_DELAY);
+            this->clk(LOW);
+            this->data(value & 0x01);
+            this->wait();
+            this->clk(HIGH);
+            this->wait();
             value >>= 1u;
         }
-        digitalWrite(clkPin_, LOW);
-        digitalWrite(dataPin_, HIGH);
-        digitalWrite(clkPin_, HIGH);
-        pinMode(dataPin_, INPUT);
-        if ((ACK = digitalRead(dataPin_)) == 0) {
-            pinMode(dataPin_, INPUT);
-            digitalWrite(dataPin_, LOW);
+        return readAck();
+    }
+
+    uint8_t readByte() const noexcept
+    {
+        uint8_t value = 0;
+        this->dataMode(INPUT);
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            this->clk(LOW);
+            this->wait();
+            this->clk(HIGH);
+            this->wait();
+            value |= static_cast<uint8_t>(this->readData() << i);
         }
-        pinMode(dataPin_, OUTPUT);
+        // Acknowledge the byte
+        this->clk(LOW);
+        this->wait();
+        this->clk(HIGH);
+        this->wait();
+        this->dataMode(OUTPUT);
+        return value;
+    }
+
+    uint8_t readAck() const noexcept
+    {
+        uint8_t ACK;
+        this->clk(LOW);
+        this->data(HIGH);
+        this->clk(HIGH);
+        this->dataMode(INPUT);
+        if ((ACK = this->readData()) == 0) {
+            this->dataMode(INPUT);
+            this->data(LOW);
+        }
+        this->dataMode(OUTPUT);
         return ACK;
     }
 
+#if TM1637_ASYNC
+    static constexpr uint8_t START = 0x01;
+    static constexpr uint8_t STOP = 0x02;
+
+    // Steps of a queued byte: start condition, 8 bits of two half clocks each, ACK, stop condition
+    enum Step : uint8_t {
+        START_IDLE,
+        START_LOW,
+        BIT_FIRST,
+        ACK_BIT = BIT_FIRST + 16,
+        STOP_LOW,
+        STOP_HIGH
+    };
+
+    void publish() const noexcept
+    {
+        const uint8_t tail = static_cast<uint8_t>((tail_ + 1) % TM1637_ASYNC_QUEUE);
+        while (tail == head_)
+            poll();
+        bytes_[tail_] = stagedValue_;
+        flags_[tail_] = stagedFlags_;
+        // The entry must be complete before poll(), maybe from an interrupt, can see it
+        tm1637_lib::detail::barrier();
+        tail_ = tail;
+        staged_ = false;
+    }
+
+    void step() const noexcept
+    {
+        const uint8_t value = bytes_[head_], flags = flags_[head_];
+        if (step_ == START_IDLE && !(flags & START))
+            step_ = BIT_FIRST;
+        if (step_ == START_IDLE) {
+            this->clk(HIGH);
+            this->data(HIGH);
+        } else if (step_ == START_LOW) {
+            this->data(LOW);
+        } else if (step_ < ACK_BIT) {
+            uint8_t bit = static_cast<uint8_t>((step_ - BIT_FIRST) >> 1u);
+            if ((step_ - BIT_FIRST) & 0x01u) {
+                this->clk(HIGH);
+            } else {
+                this->clk(LOW);
+                this->data((value >> bit) & 0x01u);
+            }
+        } else if (step_ == ACK_BIT) {
+            readAck();
+            if (!(flags & STOP))
+                return next();
+        } else if (step_ == STOP_LOW) {
+            this->clk(LOW);
+            this->data(LOW);
+            this->clk(HIGH);
+        } else {
+            this->data(HIGH);
+            return next();
+        }
+        ++step_;
+    }
+
+    void next() const noexcept
+    {
+        step_ = START_IDLE;
+        // The entry must be read before publish() can overwrite it
+        tm1637_lib::detail::barrier();
+        head_ = static_cast<uint8_t>((head_ + 1) % TM1637_ASYNC_QUEUE);
+    }
+
+    mutable uint8_t bytes_[TM1637_ASYNC_QUEUE]{};
+    mutable uint8_t flags_[TM1637_ASYNC_QUEUE]{};
+    mutable volatile uint8_t head_{};
+    mutable volatile uint8_t tail_{};
+    mutable volatile bool polling_{};
+    mutable uint8_t step_{};
+    mutable uint8_t pending_{};
+    mutable bool staged_{};
+    mutable uint8_t stagedValue_{};
+    mutable uint8_t stagedFlags_{};
+#endif
+};
+
+#if TM1637_ASYNC
+template <class Pins>
+constexpr uint8_t BasicMI2C<Pins>::START;
+
+template <class Pins>
+constexpr uint8_t BasicMI2C<Pins>::STOP;
+#endif
+
+using MI2C = BasicMI2C<tm1637_lib::detail::RuntimePins>;
+
+template <uint8_t CLK_PIN, uint8_t DATA_PIN, unsigned DELAY = TM1637_DELAY>
+using StaticMI2C = BasicMI2C<tm1637_lib::detail::StaticPins<CLK_PIN, DATA_PIN, DELAY>>;
+
+/**
+ * @brief Two-wire protocol clocking several devices at once: one CLK line shared by every device, one DIO line per
+ * device
+ * @details Each bit of a byte is written to every DIO line at the same time. With TM1637_PORT_IO and all the DIO pins
+ * on the same port, that is a single port write per bit, so updating N devices costs about as much as updating one.
+ * Otherwise the lines are written one after the other
+ * @tparam LANES Number of devices (DIO lines), at most 8
+ */
+template <uint8_t LANES>
+class ParallelMI2C
+{
+    static_assert(LANES > 0 && LANES <= 8, "A parallel bus drives between 1 and 8 devices");
+
+public:
+    static constexpr uint8_t ALL_LANES = static_cast<uint8_t>((1u << LANES) - 1u);
+
+    /**
+     * @param clkPin Clock pin shared by every device
+     * @param dataPins Data pin of each device
+     */
+    ParallelMI2C(uint8_t clkPin, const uint8_t (&dataPins)[LANES]) noexcept : clkPin_{clkPin}
+    {
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            dataPins_[lane] = dataPins[lane];
+    }
+
+    ParallelMI2C(const ParallelMI2C&) = delete;
+
+    ParallelMI2C& operator=(const ParallelMI2C&) = delete;
+
+    void begin() noexcept
+    {
+#if TM1637_PORT_IO
+        clkOut_ = portOutputRegister(digitalPinToPort(clkPin_));
+        clkMask_ = digitalPinToBitMask(clkPin_);
+        dataOut_ = portOutputRegister(digitalPinToPort(dataPins_[0]));
+        dataMode_ = portModeRegister(digitalPinToPort(dataPins_[0]));
+        dataIn_ = portInputRegister(digitalPinToPort(dataPins_[0]));
+        dataMask_ = 0;
+        shared_ = true;
+        for (uint8_t lane = 0; lane < LANES; ++lane) {
+            laneMask_[lane] = digitalPinToBitMask(dataPins_[lane]);
+            dataMask_ |= laneMask_[lane];
+            shared_ &= digitalPinToPort(dataPins_[lane]) == digitalPinToPort(dataPins_[0]);
+        }
+#endif
+        pinMode(clkPin_, OUTPUT);
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            pinMode(dataPins_[lane], OUTPUT);
+    }
+
+    void beginTransmission() const noexcept
+    {
+        clk(HIGH);
+        data(ALL_LANES);
+        wait();
+        data(0);
+    }
+
+    void endTransmission() const noexcept
+    {
+        clk(LOW);
+        data(0);
+        clk(HIGH);
+        wait();
+        data(ALL_LANES);
+    }
+
+    /**
+     * @brief Send the same byte to every device
+     * @return Lanes that did not acknowledge, one bit per device
+     */
+    uint8_t send(uint8_t value) const noexcept
+    {
+        uint8_t values[LANES];
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            values[lane] = value;
+        return send(values);
+    }
+
+    /**
+     * @brief Send one byte to each device at the same time
+     * @param values Byte of each device
+     * @return Lanes that did not acknowledge, one bit per device
+     */
+    uint8_t send(const uint8_t (&values)[LANES]) const noexcept
+    {
+        for (uint8_t i = 0; i < 8; ++i)
+        {
+            uint8_t lanes = 0;
+            for (uint8_t lane = 0; lane < LANES; ++lane)
+                lanes |= static_cast<uint8_t>(((values[lane] >> i) & 0x01u) << lane);
+            clk(LOW);
+            data(lanes);
+            wait();
+            clk(HIGH);
+            wait();
+        }
+        clk(LOW);
+        data(ALL_LANES);
+        clk(HIGH);
+        dataMode(INPUT);
+        uint8_t NAK = readData();
+        dataMode(OUTPUT);
+        return NAK;
+    }
+
+    /**
+     * @brief Bring every device back to idle after a transfer one of them did not acknowledge
+     * @details Same as BasicMI2C::recover(): nine clocks with the DIO lines released, then a stop condition
+     */
+    void recover() const noexcept
+    {
+        dataMode(INPUT);
+        for (uint8_t i = 0; i < 9; ++i)
+        {
+            clk(LOW);
+            wait();
+            clk(HIGH);
+            wait();
+        }
+        clk(LOW);
+        dataMode(OUTPUT);
+        endTransmission();
+    }
+
 private:
-    const uint8_t clkPin_, dataPin_;
+    static void wait() noexcept { delayMicroseconds(TM1637_DELAY); }
+
+#if TM1637_PORT_IO
+    void clk(uint8_t value) const noexcept { tm1637_lib::detail::writePort(clkOut_, clkMask_, value); }
+
+    void data(uint8_t lanes) const noexcept
+    {
+        if (!shared_) {
+            for (uint8_t lane = 0; lane < LANES; ++lane)
+                digitalWrite(dataPins_[lane], (lanes >> lane) & 0x01u);
+            return;
+        }
+        port_mask_t set = 0;
+        for (uint8_t lane = 0; lane < LANES; ++lane) {
+            if (lanes & (1u << lane))
+                set |= laneMask_[lane];
+        }
+#ifdef SREG
+        uint8_t oldSREG = SREG;
+        cli();
+#endif
+        *dataOut_ = static_cast<port_mask_t>((*dataOut_ & static_cast<port_mask_t>(~dataMask_)) | set);
+#ifdef SREG
+        SREG = oldSREG;
+#endif
+    }
+
+    void dataMode(uint8_t mode) const noexcept
+    {
+        if (!shared_) {
+            for (uint8_t lane = 0; lane < LANES; ++lane)
+                pinMode(dataPins_[lane], mode);
+            return;
+        }
+        // Mirror pinMode(): switching to INPUT also clears the output latches (no pull-up), after the direction
+        tm1637_lib::detail::writePort(dataMode_, dataMask_, mode == OUTPUT);
+        if (mode != OUTPUT)
+            tm1637_lib::detail::writePort(dataOut_, dataMask_, LOW);
+    }
+
+    uint8_t readData() const noexcept
+    {
+        uint8_t lanes = 0;
+        if (!shared_) {
+            for (uint8_t lane = 0; lane < LANES; ++lane)
+                lanes |= static_cast<uint8_t>(digitalRead(dataPins_[lane]) << lane);
+            return lanes;
+        }
+        port_mask_t levels = *dataIn_;
+        for (uint8_t lane = 0; lane < LANES; ++lane) {
+            if (levels & laneMask_[lane])
+                lanes |= static_cast<uint8_t>(1u << lane);
+        }
+        return lanes;
+    }
+#else
+    void clk(uint8_t value) const noexcept { digitalWrite(clkPin_, value); }
+
+    void data(uint8_t lanes) const noexcept
+    {
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            digitalWrite(dataPins_[lane], (lanes >> lane) & 0x01u);
+    }
+
+    void dataMode(uint8_t mode) const noexcept
+    {
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            pinMode(dataPins_[lane], mode);
+    }
+
+    uint8_t readData() const noexcept
+    {
+        uint8_t lanes = 0;
+        for (uint8_t lane = 0; lane < LANES; ++lane)
+            lanes |= static_cast<uint8_t>(digitalRead(dataPins_[lane]) << lane);
+        return lanes;
+    }
+#endif
+
+    const uint8_t clkPin_;
+    uint8_t dataPins_[LANES];
+#if TM1637_PORT_IO
+    using port_register_t = tm1637_lib::detail::port_register_t;
+    using port_mask_t = tm1637_lib::detail::port_mask_t;
+
+    port_register_t clkOut_{}, dataOut_{}, dataMode_{}, dataIn_{};
+    port_mask_t clkMask_{}, dataMask_{}, laneMask_[LANES]{};
+    bool shared_{};
+#endif
 };
 
+template <uint8_t LANES>
+constexpr uint8_t ParallelMI2C<LANES>::ALL_LANES;
+
 #endif //TM1637_MI2C_H
@@ -0,0 +1,93 @@
+#ifndef TM1637_SEGMENTS_H
+#define TM1637_SEGMENTS_H
+
+#include <Arduino.h>
+#include "font.h"
+
+namespace tm1637_lib
+{
+    /**
+     * @brief Text already encoded into segment bytes, see `encode()`
+     * @tparam CAPACITY Maximum number of digits
+     */
+    template <size_t CAPACITY>
+    struct Segments
+    {
+        uint8_t digits[CAPACITY];
+        uint8_t length;
+
+        constexpr const uint8_t *data() const noexcept { return digits; }
+
+        constexpr size_t size() const noexcept { return length; }
+
+        constexpr uint8_t operator[](size_t index) const noexcept { return digits[index]; }
+    };
+
+namespace detail
+{
+    template <size_t ... INDEXES>
+    struct index_sequence
+    {};
+
+    template <size_t N, size_t ... INDEXES>
+    struct make_index_sequence : make_index_sequence<N - 1, N - 1, INDEXES...>
+    {};
+
+    template <size_t ... INDEXES>
+    struct make_index_sequence<0, INDEXES...>
+    {
+        using type = index_sequence<INDEXES...>;
+    };
+
+    // Same rules as Animator::append(): a '.' lights the dot of the digit before it, if there is one
+    constexpr size_t skipDots(const char *text, size_t index) noexcept
+    {
+        return text[index] == '.' ? skipDots(text, index + 1) : index;
+    }
+
+    constexpr size_t nextDigit(const char *text, size_t index) noexcept
+    {
+        return skipDots(text, index + 1);
+    }
+
+    constexpr size_t digitStart(const char *text, size_t digit, size_t index = 0) noexcept
+    {
+        return !text[index] || !digit ? index : digitStart(text, digit - 1, nextDigit(text, index));
+    }
+
+    constexpr uint8_t encodeDigit(const char *text, size_t index) noexcept
+    {
+        return !text[index] ? 0x00 :
+               static_cast<uint8_t>(constexprGlyph(text[index]) | (text[index + 1] == '.' ? 0x80u : 0x00u));
+    }
+
+    constexpr uint8_t countDigits(const char *text, size_t index = 0) noexcept
+    {
+        return !text[index] ? 0 : static_cast<uint8_t>(1 + countDigits(text, nextDigit(text, index)));
+    }
+
+    template <size_t N, size_t ... INDEXES>
+    constexpr Segments<N> encode(const char (&text)[N], index_sequence<INDEXES...>) noexcept
+    {
+        return Segments<N>{{encodeDigit(text, digitStart(text, INDEXES))...}, countDigits(text)};
+    }
+}
+
+    /**
+     * @brief Encode a string literal into segment bytes at compile time
+     * @details Characters are encoded like `display()` does, including the '.' merged into the digit before it. Only
+     * initialising a constexpr variable guarantees compile-time encoding; called at runtime, it reads the glyphs from
+     * the flash font like `display()`
+     * @code
+     * constexpr auto PLAY = tm1637_lib::encode("PLAY");
+     * tm.display(PLAY);
+     * @endcode
+     */
+    template <size_t N>
+    constexpr Segments<N> encode(const char (&text)[N]) noexcept
+    {
+        return detail::encode(text, typename detail::make_index_sequence<N>::type{});
+    }
+}
+
+#endif //TM1637_SEGMENTS_H
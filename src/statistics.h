@@ -0,0 +1,31 @@
+#ifndef TM1637_STATISTICS_H
+#define TM1637_STATISTICS_H
+
+#include <Arduino.h>
+
+// Count the bus traffic of each display, see BasicTM1637::getStatistics()
+#ifndef TM1637_STATS
+#define TM1637_STATS 0
+#endif
+
+namespace tm1637_lib
+{
+    /**
+     * @brief Bus traffic of a display since it was created or since the last `resetStatistics()`
+     * @details With TM1637_ASYNC the bytes are counted, and the time measured, when they are queued. NAKs can't be seen
+     * then
+     */
+    struct Statistics
+    {
+        uint32_t transactions;      // Start conditions sent
+        uint32_t bytes;             // Bytes sent
+        uint32_t naks;              // Bytes the device did not acknowledge
+        uint32_t retries;           // Frames sent again after a NAK
+        uint32_t frames;            // Frames sent: content refreshes and display control changes
+        uint32_t skippedFrames;     // Frames that sent nothing: unchanged content or commands the device already holds
+        uint32_t busMicros;         // Time spent sending frames, in microseconds
+        uint32_t maxFrameMicros;    // Longest frame, in microseconds
+    };
+}
+
+#endif //TM1637_STATISTICS_H
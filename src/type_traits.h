@@ -296,6 +296,10 @@ namespace type_traits
     struct is_integral: is_integral_base<typename decay<T>::type>
     {};
 
+    template <typename T>
+    struct is_signed: integral_constant<bool, ((typename decay<T>::type)(-1) < (typename decay<T>::type)(0))>
+    {};
+
     template <typename T>
     struct is_floating_point_base: false_type
     {};
@@ -328,6 +332,10 @@ namespace type_traits
     struct is_string_base<String>: true_type
     {};
 
+    template <>
+    struct is_string_base<const __FlashStringHelper*>: true_type
+    {};
+
     template <typename T>
     struct is_string: is_string_base<typename remove_reference<T>::type >
     {};